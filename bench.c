@@ -0,0 +1,389 @@
+﻿#if !defined(_WIN32) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 600 /* clock_gettime() getrusage() */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include "leptjson.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>   /* GetProcessMemoryInfo() */
+#else
+#include <time.h>    /* clock_gettime() */
+#include <sys/resource.h> /* getrusage() */
+#endif
+
+/* 每个语料、每种操作输出一行 JSON（NDJSON），便于脚本比较前后两次的结果：
+ *   {"corpus":..,"op":"parse|parse_utf8|parse_lazy|validate|stringify|roundtrip","bytes":..,"values":..,"iterations":..,
+ *    "mb_per_s":..,"ns_per_value":..,"allocs_per_doc":..,"peak_rss_kb":..}
+ * 速度取最快的一次迭代；allocs_per_doc 是每次迭代平均经过 lept_allocator 的 malloc/realloc 调用数；
+ * peak_rss_kb 是进程的峰值常驻内存，Linux 上每种操作开始前会重置，其他平台上单调不减 */
+
+/* 作为全局分配器统计库的分配次数；只在单线程下使用 */
+static size_t bench_allocs = 0;
+
+static void *bench_malloc(void *ctx, size_t size) {
+	(void)ctx;
+	bench_allocs++;
+	return malloc(size);
+}
+
+static void *bench_realloc(void *ctx, void *p, size_t size) {
+	(void)ctx;
+	bench_allocs++;
+	return realloc(p, size);
+}
+
+static void bench_free(void *ctx, void *p) {
+	(void)ctx;
+	free(p);
+}
+
+typedef struct {
+	char *s;
+	size_t len, size;
+}bench_buf;
+
+static double bench_now(void) {
+#ifdef _WIN32
+	LARGE_INTEGER f, t;
+	QueryPerformanceFrequency(&f);
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart / (double)f.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static void bench_reset_peak_rss(void) {
+#ifdef __linux__
+	/* 写入 5 会把 VmHWM 重置为当前的 RSS（Linux 4.0 起） */
+	FILE *fp = fopen("/proc/self/clear_refs", "w");
+	if (fp != NULL) {
+		fputs("5", fp);
+		fclose(fp);
+	}
+#endif
+}
+
+static long bench_peak_rss_kb(void) {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		return -1;
+	return (long)(pmc.PeakWorkingSetSize / 1024);
+#elif defined(__linux__)
+	/* 重置后 ru_maxrss 不会跟着变小，要读 /proc 中的 VmHWM */
+	char line[128];
+	long kb = -1;
+	FILE *fp = fopen("/proc/self/status", "r");
+	if (fp != NULL) {
+		while (fgets(line, sizeof(line), fp) != NULL)
+			if (sscanf(line, "VmHWM: %ld kB", &kb) == 1)
+				break;
+		fclose(fp);
+	}
+	return kb;
+#else
+	struct rusage ru;
+	if (getrusage(RUSAGE_SELF, &ru) != 0)
+		return -1;
+#ifdef __APPLE__
+	return (long)(ru.ru_maxrss / 1024);
+#else
+	return (long)ru.ru_maxrss;
+#endif
+#endif
+}
+
+static void bench_append(bench_buf *b, const char *s, size_t len) {
+	if (b->len + len + 1 > b->size) {
+		while (b->len + len + 1 > b->size)
+			b->size = b->size == 0 ? 4096 : b->size + (b->size >> 1);
+		b->s = (char *)realloc(b->s, b->size);
+	}
+	memcpy(b->s + b->len, s, len);
+	b->len += len;
+	b->s[b->len] = '\0';
+}
+
+static void bench_puts(bench_buf *b, const char *s) {
+	bench_append(b, s, strlen(s));
+}
+
+static void bench_printf(bench_buf *b, const char *fmt, ...) {
+	char tmp[64];
+	va_list ap;
+	va_start(ap, fmt);
+	bench_append(b, tmp, (size_t)vsprintf(tmp, fmt, ap));
+	va_end(ap);
+}
+
+/* xorshift32：生成器的输出只取决于种子，每次运行都得到相同的文档 */
+static uint32_t bench_rand(uint32_t *state) {
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+/* 64 条链，每条 2048 层，数组与对象交替嵌套 */
+static void bench_gen_deep(bench_buf *b) {
+	int i, d, depth = 2048;
+	bench_puts(b, "[");
+	for (i = 0; i < 64; i++) {
+		if (i > 0)
+			bench_puts(b, ",");
+		for (d = 0; d < depth; d++)
+			bench_puts(b, d & 1 ? "{\"k\":" : "[1,");
+		bench_puts(b, "null");
+		for (d = depth - 1; d >= 0; d--)
+			bench_puts(b, d & 1 ? "}" : "]");
+	}
+	bench_puts(b, "]");
+}
+
+/* 一个有 200000 个成员的对象，值是整数和短字符串 */
+static void bench_gen_wide(bench_buf *b) {
+	int i;
+	bench_puts(b, "{");
+	for (i = 0; i < 200000; i++)
+		bench_printf(b, i & 1 ? "%s\"key%d\":\"v%d\"" : "%s\"key%d\":%d", i == 0 ? "" : ",", i, i);
+	bench_puts(b, "}");
+}
+
+/* 100000 个长度不一的字符串，夹杂转义、\u 转义和 UTF-8 */
+static void bench_gen_strings(bench_buf *b) {
+	static const char *pieces[] = { "a", "b", "c", "d", "e", "f", "g", "h", " ", "0", "\\n", "\\\"", "\\\\", "\\u00e9", "\xc3\xa9", "\xe4\xb8\xad" };
+	uint32_t seed = 0x1234567;
+	int i, j, n;
+	bench_puts(b, "[");
+	for (i = 0; i < 100000; i++) {
+		bench_puts(b, i == 0 ? "\"" : ",\"");
+		n = (int)(bench_rand(&seed) % 96);
+		for (j = 0; j < n; j++) {
+			uint32_t r = bench_rand(&seed) % 64;
+			/* 大部分是 ASCII，大约八分之一是转义或多字节字符 */
+			bench_puts(b, pieces[r < 56 ? r % 10 : 10 + (r - 56) % 6]);
+		}
+		bench_puts(b, "\"");
+	}
+	bench_puts(b, "]");
+}
+
+/* 250000 个数字：整数、短小数、17 位有效数字的随机 double 和带指数的数 */
+static void bench_gen_numbers(bench_buf *b) {
+	uint32_t seed = 0x7654321;
+	int i;
+	bench_puts(b, "[");
+	for (i = 0; i < 250000; i++) {
+		uint32_t r = bench_rand(&seed);
+		const char *sep = i == 0 ? "" : ",";
+		switch (r % 4) {
+			case 0: bench_printf(b, "%s%d", sep, (int)(bench_rand(&seed) % 2000001) - 1000000); break;
+			case 1: bench_printf(b, "%s%u.%02u", sep, bench_rand(&seed) % 10000, bench_rand(&seed) % 100); break;
+			case 2: {
+				uint64_t bits = (uint64_t)bench_rand(&seed) << 32 | bench_rand(&seed);
+				double d;
+				/* 指数限制在 [2^-64, 2^64) 内，避免 NaN 和无穷 */
+				bits = (bits & 0x800FFFFFFFFFFFFFULL) | (uint64_t)(1023 - 64 + bench_rand(&seed) % 128) << 52;
+				memcpy(&d, &bits, sizeof(d));
+				bench_printf(b, "%s%.17g", sep, d);
+				break;
+			}
+			default: bench_printf(b, "%s%ue%d", sep, bench_rand(&seed) % 1000, (int)(bench_rand(&seed) % 601) - 300); break;
+		}
+	}
+	bench_puts(b, "]");
+}
+
+static size_t bench_count_values(const lept_value *v) {
+	size_t i, n = 1;
+	switch (lept_get_type(v)) {
+		case LEPT_ARRAY:
+			for (i = 0; i < lept_get_array_size(v); i++)
+				n += bench_count_values(lept_get_array_element(v, i));
+			break;
+		case LEPT_OBJECT:
+			for (i = 0; i < lept_get_object_size(v); i++)
+				n += bench_count_values(lept_get_object_value(v, i));
+			break;
+		default: break;
+	}
+	return n;
+}
+
+static char *bench_read_file(const char *path, size_t *len) {
+	FILE *fp = fopen(path, "rb");
+	char *json;
+	long n;
+	if (fp == NULL)
+		return NULL;
+	fseek(fp, 0, SEEK_END);
+	n = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	json = (char *)malloc((size_t)n + 1);
+	*len = fread(json, 1, (size_t)n, fp);
+	json[*len] = '\0';
+	fclose(fp);
+	return json;
+}
+
+typedef enum { BENCH_PARSE, BENCH_PARSE_UTF8, BENCH_PARSE_LAZY, BENCH_VALIDATE, BENCH_STRINGIFY, BENCH_ROUNDTRIP }bench_op;
+
+static const char *bench_op_names[] = { "parse", "parse_utf8", "parse_lazy", "validate", "stringify", "roundtrip" };
+
+/* 重复执行 op，直到累计计时超过 min_seconds（至少 3 次） */
+static void bench_run(const char *corpus, char *json, size_t len, size_t values, bench_op op, double min_seconds) {
+	lept_value v, parsed;
+	lept_parse_options opt;
+	double total = 0.0, best = 1e300, t;
+	size_t iterations = 0, bytes = len, allocs = 0, out_len;
+	char *out;
+	opt.flags = LEPT_PARSE_FLAG_VALIDATE_UTF8;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 0;
+	opt.stats = NULL;
+	opt.allocator = NULL;
+	opt.offset = NULL;
+	lept_init(&parsed);
+	if (op == BENCH_STRINGIFY)
+		lept_parse(&parsed, json);
+	bench_reset_peak_rss();
+	while (iterations < 3 || total < min_seconds) {
+		size_t before = bench_allocs;
+		lept_init(&v);
+		switch (op) {
+			case BENCH_PARSE:
+				t = bench_now();
+				lept_parse(&v, json);
+				t = bench_now() - t;
+				allocs += bench_allocs - before;
+				lept_free(&v);
+				break;
+			case BENCH_PARSE_UTF8:
+				/* 与 parse 相比即字符串内校验 UTF-8 的开销 */
+				t = bench_now();
+				lept_parse_ex(&v, json, &opt);
+				t = bench_now() - t;
+				allocs += bench_allocs - before;
+				lept_free(&v);
+				break;
+			case BENCH_PARSE_LAZY:
+				/* 只建立根容器这一层 */
+				t = bench_now();
+				lept_parse_lazy(&v, json, len, 0);
+				t = bench_now() - t;
+				allocs += bench_allocs - before;
+				lept_free(&v);
+				break;
+			case BENCH_VALIDATE:
+				t = bench_now();
+				lept_validate(json, len, 0, NULL);
+				t = bench_now() - t;
+				allocs += bench_allocs - before;
+				break;
+			case BENCH_STRINGIFY:
+				t = bench_now();
+				lept_stringify(&parsed, &out, &out_len);
+				t = bench_now() - t;
+				allocs += bench_allocs - before;
+				bytes = out_len;
+				free(out);
+				break;
+			default:
+				t = bench_now();
+				lept_parse(&v, json);
+				lept_free(&v);
+				t = bench_now() - t;
+				allocs += bench_allocs - before;
+				break;
+		}
+		total += t;
+		if (t < best)
+			best = t;
+		iterations++;
+	}
+	lept_free(&parsed);
+	printf("{\"corpus\":\"%s\",\"op\":\"%s\",\"bytes\":%lu,\"values\":%lu,\"iterations\":%lu,"
+		"\"mb_per_s\":%.2f,\"ns_per_value\":%.2f,",
+		corpus, bench_op_names[op], (unsigned long)bytes, (unsigned long)values, (unsigned long)iterations,
+		bytes / best / (1024.0 * 1024.0), best * 1e9 / values);
+	printf("\"allocs_per_doc\":%.2f,\"peak_rss_kb\":%ld}\n", (double)allocs / iterations, bench_peak_rss_kb());
+	fflush(stdout);
+}
+
+static void bench_corpus(const char *corpus, char *json, size_t len, double min_seconds) {
+	lept_value v;
+	size_t values;
+	int ret;
+	lept_init(&v);
+	if ((ret = lept_parse(&v, json)) != LEPT_PARSE_OK) {
+		fprintf(stderr, "%s: parse error %d\n", corpus, ret);
+		return;
+	}
+	values = bench_count_values(&v);
+	lept_free(&v);
+	bench_run(corpus, json, len, values, BENCH_PARSE, min_seconds);
+	bench_run(corpus, json, len, values, BENCH_PARSE_UTF8, min_seconds);
+	bench_run(corpus, json, len, values, BENCH_PARSE_LAZY, min_seconds);
+	bench_run(corpus, json, len, values, BENCH_VALIDATE, min_seconds);
+	bench_run(corpus, json, len, values, BENCH_STRINGIFY, min_seconds);
+	bench_run(corpus, json, len, values, BENCH_ROUNDTRIP, min_seconds);
+}
+
+/* 用法：leptjson_bench [-t 每项最少秒数] [语料目录]
+ * 语料目录中找不到的标准语料（twitter.json 等）会跳过，合成文档总是会测 */
+int main(int argc, char *argv[]) {
+	static const char *corpora[] = { "twitter.json", "canada.json", "citm_catalog.json" };
+	static const struct {
+		const char *name;
+		void (*gen)(bench_buf *);
+	}synthetic[] = {
+		{ "synthetic:deep", bench_gen_deep },
+		{ "synthetic:wide", bench_gen_wide },
+		{ "synthetic:strings", bench_gen_strings },
+		{ "synthetic:numbers", bench_gen_numbers }
+	};
+	const char *dir = "data";
+	double min_seconds = 1.0;
+	char path[4096], *json;
+	size_t i, len;
+	lept_allocator counting;
+	counting.malloc_fn = bench_malloc;
+	counting.realloc_fn = bench_realloc;
+	counting.free_fn = bench_free;
+	counting.ctx = NULL;
+	lept_set_allocator(&counting);
+	for (i = 1; i < (size_t)argc; i++) {
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < (size_t)argc)
+			min_seconds = atof(argv[++i]);
+		else
+			dir = argv[i];
+	}
+	for (i = 0; i < sizeof(corpora) / sizeof(corpora[0]); i++) {
+		sprintf(path, "%.4000s/%s", dir, corpora[i]);
+		if ((json = bench_read_file(path, &len)) == NULL) {
+			fprintf(stderr, "%s: not found, skipped\n", path);
+			continue;
+		}
+		bench_corpus(corpora[i], json, len, min_seconds);
+		free(json);
+	}
+	for (i = 0; i < sizeof(synthetic) / sizeof(synthetic[0]); i++) {
+		bench_buf b;
+		b.s = NULL;
+		b.len = b.size = 0;
+		synthetic[i].gen(&b);
+		bench_corpus(synthetic[i].name, b.s, b.len, min_seconds);
+		free(b.s);
+	}
+	return 0;
+}
@@ -1,37 +1,351 @@
-﻿#define _WINDOWS
+﻿#if defined(_MSC_VER) && !defined(_WINDOWS)
+#define _WINDOWS
+#endif
 #ifdef _WINDOWS
 #define _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
 #endif
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L /* mmap() posix_madvise() */
+#endif
+
 #include "leptjson.h"
 #include <assert.h>  /* assert */
-#include <stdlib.h>  /* NULL strtod() */
-#include <errno.h>   /* errno, ERANGE */
-#include <math.h>    /* HUGE_VAL */
+#include <stdlib.h>  /* NULL malloc() */
+#include <float.h>   /* FLT_EVAL_METHOD */
 #include <string.h>  /* memcpy*/
-#include <stdio.h>   /* sprintf() */
+#include <stdint.h>  /* uintptr_t uint64_t */
+#include <stdio.h>   /* fwrite() */
+#ifdef _WIN32
+#include <io.h>      /* _write() */
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h> /* CreateFileMapping() */
+#else
+#include <unistd.h>  /* write() close() */
+#include <errno.h>   /* EINTR */
+#include <fcntl.h>   /* open() */
+#include <sys/mman.h> /* mmap() */
+#include <sys/stat.h> /* fstat() */
+#include <time.h>    /* clock_gettime() */
+#include <pthread.h>
+#endif
+
+/* 运行时按 CPU 支持选择 SSE2/AVX2 扫描内核；定义 LEPT_NO_SIMD 可只保留标量实现 */
+#if !defined(LEPT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define LEPT_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER) || defined(__GNUC__)
+#define LEPT_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LEPT_TARGET_AVX2
+static int lept_ctz(unsigned x) { unsigned long i; _BitScanForward(&i, x); return (int)i; }
+static int lept_ctz64(uint64_t x) { return (uint32_t)x != 0 ? lept_ctz((unsigned)x) : 32 + lept_ctz((unsigned)(x >> 32)); }
+#else
+#define LEPT_TARGET_AVX2 __attribute__((target("avx2")))
+#define lept_ctz(x) __builtin_ctz(x)
+#define lept_ctz64(x) __builtin_ctzll(x)
+#endif
 
+/* 一层尚未闭合的数组或对象，size 个元素 / 成员已经压在 c->stack 上 */
 typedef struct {
-	const char *json;
+	lept_type type;
+	size_t size;
+	lept_member key;	/* has_key 时为对象中已经读完、还在等待值的键 */
+	int has_key;
+}lept_parser_frame;
+
+/* 惰性解析的选项：根容器的块尾复制一份，之后各层解码都沿用它（stats 和 offset 除外） */
+typedef struct {
+	const lept_allocator *allocator;	/* 指向 lept_global_allocator 或下面的副本 */
+	lept_allocator custom;
+	lept_arena *arena;
+	lept_symtab *symtab;
+	size_t max_depth;
+	unsigned flags;
+}lept_lazy_options;
+
+/* 惰性节点的 u.s.s 指向它，放在所在元素 / 成员块的块尾；节点本身的 u.s.len 仍是原文长度 */
+typedef struct {
+	const char *json;	/* 原文开头（引号 / 括号） */
+	const lept_lazy_options *opt;
+	size_t depth;		/* 节点外面已经有几层数组 / 对象 */
+}lept_lazy_span;
+
+typedef struct {
+	const char *json, *end;	/* 输入是 [json, end)，不依赖结尾的 '\0' */
 	void *stack;
 	size_t size, top;
+	lept_parser_frame *frames;	/* 解析时尚未闭合的各层，与 stack 一样可以在多次解析之间复用 */
+	size_t frames_size, max_depth;	/* max_depth 为 0 表示不限制 */
+	lept_arena *arena;
+	lept_symtab *symtab;	/* 非 NULL 时键都驻留到这个表中 */
+	lept_stats *stats;	/* 非 NULL 且定义了 LEPT_STATS 时记录性能计数 */
+	const lept_allocator *allocator;	/* 栈、树和输出缓冲区都从它分配 */
+	unsigned flags;
+	lept_write_fn write;	/* 非 NULL 时 stringify 的输出分段交给它，栈不超过 flush_size */
+	void *write_ctx;
+	size_t flush_size;
+	int error;	/* stringify 中第一次出错的错误码（LEPT_STRINGIFY_SINK_ERROR 或 LEPT_PARSE_OUT_OF_MEMORY），0 表示没有出错 */
+	const lept_lazy_options *lazy;	/* 解码惰性节点时为根解析的选项，根解析时为 NULL */
+	size_t lazy_depth;	/* 解码惰性节点时它外面的层数 */
 }lept_context;
 
+/* 性能计数只在定义了 LEPT_STATS 时编译进来，否则这些宏都是空的，热路径上没有任何额外代码 */
+#ifdef LEPT_STATS
+#define LEPT_STATS_ADD(c, field, n) \
+	do { \
+		if ((c)->stats != NULL) \
+			(c)->stats->field += (n); \
+	} while(0)
+#define LEPT_STATS_MAX(c, field, n) \
+	do { \
+		if ((c)->stats != NULL && (c)->stats->field < (n)) \
+			(c)->stats->field = (n); \
+	} while(0)
+/* 执行 stmt 并把耗时累加到 field；没有请求计数时不读时钟 */
+#define LEPT_STATS_TIMED(c, field, stmt) \
+	do { \
+		uint64_t lept_stats_t0 = lept_stats_now(c); \
+		stmt; \
+		LEPT_STATS_ADD(c, field, lept_stats_now(c) - lept_stats_t0); \
+	} while(0)
+#define LEPT_STATS_BEGIN(c) lept_stats_begin(c)
+#define LEPT_STATS_END(c, bytes) lept_stats_end(c, bytes)
+#else
+#define LEPT_STATS_ADD(c, field, n) ((void)0)
+#define LEPT_STATS_MAX(c, field, n) ((void)0)
+#define LEPT_STATS_TIMED(c, field, stmt) do { stmt; } while(0)
+#define LEPT_STATS_BEGIN(c) ((void)0)
+#define LEPT_STATS_END(c, bytes) ((void)0)
+#endif
+
+/* 结构字符索引：字符串外的 {}[]:, 以及每个字符串开头的 '"' 在输入中的偏移 */
+typedef struct {
+	uint32_t *pos;
+	size_t count, size;
+}lept_structural_index;
+
+struct lept_arena_chunk {
+	lept_arena_chunk *next;
+	size_t size, top;
+};
+
+/* 值的 payload（字符串、元素块、成员块及其子树）不归该值所有，lept_free 不释放 */
+#define LEPT_VALUE_BORROWED 0x01
+/* 成员的键不归该成员所有（arena、原地解析）。记在成员值的 flags 高位，lept_free 保留这些位 */
+#define LEPT_KEY_BORROWED 0x10
+#define LEPT_KEY_FLAGS 0xF0
+/* 对象的成员块前有一个 lept_object_header 槽位，成员块实际从 m - 1 开始分配 */
+#define LEPT_OBJECT_HEADER 0x02
+/* 短字符串直接存放在 v->u 的字节中 / 短键直接存放在成员开头 k、klen 的字节中，不另外分配 */
+#define LEPT_STRING_INLINE 0x04
+#define LEPT_KEY_INLINE 0x20
+/* 键是 lept_symtab 中的规范副本（同时带有 LEPT_KEY_BORROWED），前面是 lept_symbol 头 */
+#define LEPT_KEY_INTERNED 0x40
+/* 惰性解析中尚未解码的字符串、数组或对象：u.s.s 指向它的 lept_lazy_span，u.s.len 为原文长度（含引号 / 括号），
+ * 同时带有 LEPT_VALUE_BORROWED */
+#define LEPT_VALUE_LAZY 0x08
+
+/* 访问函数读取 v 的内容之前先解码惰性节点；树在逻辑上不变，所以对 const 的 v 也这样做。
+ * 解码失败时 v 保持惰性，访问函数返回 fail */
+#define LEPT_LAZY_LOAD(v, fail) \
+	do { \
+		if (((v)->flags & LEPT_VALUE_LAZY) && lept_lazy_load((lept_value *)(v)) != LEPT_PARSE_OK) \
+			return fail; \
+	} while(0)
+
+#define LEPT_STRING_INLINE_SIZE sizeof(((lept_value *)0)->u)
+#define LEPT_KEY_INLINE_SIZE offsetof(lept_member, v)
+
+/* 内联存储的最后一个字节记录剩余容量，长度取满时它正好是结尾的 '\0' */
+#define LEPT_INLINE_LEN(p, size) ((size) - 1 - (unsigned char)(p)[(size) - 1])
+
+#define LEPT_STRING_DATA(v) ((v)->flags & LEPT_STRING_INLINE ? (char *)&(v)->u : (v)->u.s.s)
+#define LEPT_STRING_LEN(v) ((v)->flags & LEPT_STRING_INLINE ? LEPT_INLINE_LEN((const char *)&(v)->u, LEPT_STRING_INLINE_SIZE) : (size_t)(v)->u.s.len)
+#define LEPT_KEY_DATA(m) ((m)->v.flags & LEPT_KEY_INLINE ? (char *)(m) : (m)->k)
+#define LEPT_KEY_LEN(m) ((m)->v.flags & LEPT_KEY_INLINE ? LEPT_INLINE_LEN((const char *)(m), LEPT_KEY_INLINE_SIZE) : (size_t)(m)->klen)
+
+/* 成员数不少于该值的对象才预留索引槽位，更小的对象线性查找更快 */
+#ifndef LEPT_OBJECT_INDEX_THRESHOLD
+#define LEPT_OBJECT_INDEX_THRESHOLD 16
+#endif
+
+/* 占用成员块前一个 lept_member 大小的槽位；紧凑布局下成员块只保证 4 字节对齐 */
+#ifdef LEPT_COMPACT
+#pragma pack(push, 4)
+#endif
+typedef struct {
+	uint32_t *slots;	/* 开放寻址表，存成员下标 + 1，0 为空；首次查找前为 NULL */
+	lept_arena *arena;	/* 非 NULL 时表从该 arena 分配，随 arena 释放 */
+	/* 首次查找时可以建立索引：用 arena 或全局分配器解析。单独的分配器不保存在树中（它不必比树活得久），
+	 * 这时只有解析时（LEPT_PARSE_FLAG_INDEX_OBJECTS）才建立索引，否则线性查找 */
+	int lazy_index;
+}lept_object_header;
+#ifdef LEPT_COMPACT
+#pragma pack(pop)
+#endif
+
+typedef char lept_object_header_fits[sizeof(lept_object_header) <= sizeof(lept_member) ? 1 : -1];
+
+#define LEPT_OBJECT_HEADER_OF(v) ((lept_object_header *)(void *)((v)->u.o.m - 1))
+
+/* 字符串长度、数组和对象的大小存放在 lept_size 中 */
+#ifdef LEPT_COMPACT
+#define LEPT_SIZE_MAX UINT32_MAX
+#else
+#define LEPT_SIZE_MAX SIZE_MAX
+#endif
+
+/* 遍历树（释放、stringify）时尚未走完的一层：容器 v 正在处理第 i 个子节点 */
+typedef struct {
+	const lept_value *v;
+	size_t i;
+}lept_walk_frame;
+
+/* 前 LEPT_WALK_STACK_SIZE 层放在调用者的栈上，更深时才改用堆 */
+#ifndef LEPT_WALK_STACK_SIZE
+#define LEPT_WALK_STACK_SIZE 32
+#endif
+
+typedef struct {
+	lept_walk_frame *frames, stack[LEPT_WALK_STACK_SIZE];
+	size_t depth, size;
+	const lept_allocator *allocator;
+}lept_walk;
+
+#define LEPT_CHILD_COUNT(v) ((v)->type == LEPT_ARRAY ? (size_t)(v)->u.arr.size : (v)->type == LEPT_OBJECT ? (size_t)(v)->u.o.size : 0)
+#define LEPT_CHILD(c, i) ((c)->type == LEPT_ARRAY ? &(c)->u.arr.e[i] : &(c)->u.o.m[i].v)
+
+#define LEPT_ARENA_ALIGN(n) (((n) + sizeof(double) - 1) & ~(sizeof(double) - 1))
+
+/* 查询路径的一段 */
+typedef struct {
+	const char *key;	/* 还原了 ~0 和 ~1 的键，以 '\0' 结尾 */
+	size_t len;
+	size_t index;		/* 作为数组下标的值；不是合法下标时为 LEPT_KEY_NOT_EXIST */
+	int wildcard;		/* "*"：匹配任意成员或元素 */
+}lept_query_segment;
+
+/* lept_query_run 中路径上一层尚未走完的数组 / 对象 */
+typedef struct {
+	size_t i;	/* 正在处理第 i 个元素 / 成员 */
+	char close;
+}lept_query_frame;
+
 static int lept_parse_value(lept_context *, lept_value *);
 static void lept_parse_whitespace(lept_context *);
 static int lept_parse_number(lept_context *, lept_value *);
+static uint64_t lept_eisel_lemire(uint64_t, long);
+static uint64_t lept_decimal_to_double_slow(const char *, const char *, uint64_t);
 static int lept_parse_literal(lept_context *, lept_value *, const char *, const lept_type);
 static void *lept_context_push(lept_context *, size_t);
+static int lept_context_putc(lept_context *, char);
+static int lept_context_puts(lept_context *, const char *, size_t);
 static void *lept_context_pop(lept_context *, size_t);
 static int lept_parse_string(lept_context *, lept_value *);
-static char *lept_parse_hex4(char *, unsigned *);
-static int lept_encode_utf8(lept_context *, const unsigned);
-static int lept_parse_array(lept_context *, lept_value *);
+static const char *lept_parse_hex4(const char *, const char *, unsigned *);
+static char *lept_encode_utf8(char *, const unsigned);
+static const char *lept_parse_escape(const char *, const char *, char *, size_t *, int *);
+static void lept_member_free_key(const lept_allocator *, lept_member *);
+static void lept_free_payload(const lept_allocator *, lept_value *);
+static void lept_walk_init(lept_walk *, const lept_allocator *);
+static int lept_walk_push(lept_walk *, const lept_value *);
+static void lept_walk_free(lept_walk *);
+static int lept_member_set_key(lept_context *, lept_member *, char *, size_t);
+static int lept_context_set_string(lept_context *, lept_value *, char *, size_t);
+static void lept_inline_store(char *, size_t, const char *, size_t);
+static int lept_object_build_index(const lept_value *, const lept_allocator *);
+static const uint32_t *lept_object_slots(const lept_value *);
 static int lept_parse_string_raw(lept_context *, char **, size_t *);
-static int lept_parse_object(lept_context *, lept_value *);
-static int lept_stringify_value(lept_context *, lept_value *);
+static int lept_parse_key(lept_context *, lept_parser_frame *);
+static lept_parser_frame *lept_context_push_frame(lept_context *, size_t);
+static int lept_parse_range(lept_value *, const char *, const char *, const lept_parse_options *);
+static int lept_context_pop_array(lept_context *, lept_value *, size_t);
+static int lept_context_pop_object(lept_context *, lept_value *, size_t);
+static void lept_parser_clear(lept_parser *);
+static void lept_parser_release(lept_parser *, size_t);
+static const char *lept_parser_run(lept_parser *, const char *, const char *);
+static void lept_parser_fail(lept_parser *, int);
+static void lept_parser_add_value(lept_parser *, lept_value *);
+static void lept_parser_open(lept_parser *, lept_type);
+static void lept_parser_close(lept_parser *);
+static void lept_parser_begin_value(lept_parser *, char);
+static const char *lept_parser_string(lept_parser *, const char *, const char *);
+static const char *lept_parser_escape(lept_parser *, const char *, const char *);
+static const char *lept_parser_number(lept_parser *, const char *, const char *);
+static int lept_number_next(int, char);
+static int lept_escape_complete(const char *, size_t);
+static void lept_ndjson_worker(void *);
+static unsigned lept_cpu_count(void);
+static int lept_index_structurals(lept_structural_index *, const char *, size_t);
+static size_t lept_index_top_level(const char *, lept_structural_index *);
+static void lept_parallel_worker(void *);
+static uint32_t lept_hash_key(const char *, size_t);
+static const char *lept_symtab_lookup(const lept_symtab *, const char *, size_t, uint32_t);
+static const char *lept_symtab_insert(lept_symtab *, const char *, size_t, uint32_t);
+static int lept_sax_value(lept_context *, const lept_sax_handler *, void *);
+static int lept_sax_key(lept_context *, const lept_sax_handler *, void *);
+static int lept_stringify_value(lept_context *, const lept_value *);
+static const lept_value *lept_stringify_child(lept_context *, const lept_value *, size_t);
 static void lept_stringify_string(lept_context *, const char *, size_t);
+static char lept_escape_char(unsigned char);
+static size_t lept_escaped_size(const char *, size_t);
+static char *lept_write_escaped(char *, const char *, size_t);
+static void lept_stringify_raw(lept_context *, const char *, size_t);
+static char *lept_stringify_reserve(lept_context *, size_t);
+static void lept_stringify_flush(lept_context *);
+static char *lept_write_double(char *, double);
+static uint64_t lept_round_to_odd(const uint64_t *, uint64_t);
+static int lept_parse_context(lept_context *, lept_value *);
+static int lept_parse_lazy_value(lept_context *, lept_value *, size_t);
+static int lept_skip_string(lept_context *, int);
+static int lept_skip_container(lept_context *, size_t);
+static int lept_skip_validate(lept_context *, size_t);
+static int lept_skip_key(lept_context *);
+static int lept_lazy_load(lept_value *);
+static size_t lept_lazy_tail_size(const lept_context *, size_t, size_t, size_t);
+static void lept_lazy_attach(lept_context *, lept_value *, char *);
+static size_t lept_query_index(const char *, size_t);
+static int lept_query_child(lept_context *, const lept_query_segment *, lept_query_frame *, int *);
+static int lept_query_emit(lept_context *, lept_query_fn, void *);
+static int lept_query_skip(lept_context *);
+static void *lept_context_alloc(lept_context *, size_t);
+#ifdef LEPT_STATS
+static uint64_t lept_stats_now(const lept_context *);
+static void lept_stats_begin(lept_context *);
+static void lept_stats_end(lept_context *, size_t);
+#endif
+static void *lept_arena_alloc(lept_arena *, size_t);
+static const char *lept_skip_whitespace_scalar(const char *, const char *);
+static const char *lept_scan_string_scalar(const char *, const char *);
+static const char *lept_scan_string_utf8_scalar(const char *, const char *);
+static void lept_simd_init(void);
+
+static void *lept_std_malloc(void *ctx, size_t size) { (void)ctx; return malloc(size); }
+static void *lept_std_realloc(void *ctx, void *p, size_t size) { (void)ctx; return realloc(p, size); }
+static void lept_std_free(void *ctx, void *p) { (void)ctx; free(p); }
+
+/* 没有指定分配器时使用；lept_set_allocator() 只应在还没有任何分配时调用 */
+static lept_allocator lept_global_allocator = { lept_std_malloc, lept_std_realloc, lept_std_free, NULL };
+
+#define LEPT_MALLOC(a, size) ((a)->malloc_fn((a)->ctx, (size)))
+#define LEPT_REALLOC(a, p, size) ((a)->realloc_fn((a)->ctx, (p), (size)))
+#define LEPT_FREE(a, p) ((a)->free_fn((a)->ctx, (p)))
+
+/* 在 [p, end) 内跳过空白 / 找到字符串中下一个 '"'、'\\' 或控制字符，没有时返回 end；实现由 lept_simd_init() 选定 */
+static const char *(*lept_skip_whitespace)(const char *, const char *) = lept_skip_whitespace_scalar;
+static const char *(*lept_scan_string)(const char *, const char *) = lept_scan_string_scalar;
+/* 同 lept_scan_string，同时校验经过的 UTF-8，停在第一个不合法序列的开头；p 之前须是 ASCII 字符 */
+static const char *(*lept_scan_string_utf8)(const char *, const char *) = lept_scan_string_utf8_scalar;
+
+/* 读到输入末尾时得到 '\0'，各处的错误码因此与以 '\0' 结尾的输入一致 */
+#define PEEK(c) ((c)->json != (c)->end ? *(c)->json : '\0')
 
 #define EXPECT(c, ch) \
 	do { \
@@ -43,6 +357,694 @@ static void lept_stringify_string(lept_context *, const char *, size_t);
 
 #define ISDIGIT1_9(ch) ( (ch) >= '1' && (ch) <= '9')
 
+#define ISWHITESPACE(ch) ((ch) == ' ' || (ch) == '\t' || (ch) == '\n' || (ch) == '\r')
+
+#define LEPT_POW5_MIN (-342)
+#define LEPT_POW5_MAX 324
+#define LEPT_DOUBLE_MAX_EXP10 308
+#define LEPT_DOUBLE_EXACT_INT (1ULL << 53)
+#define LEPT_DOUBLE_INF_BITS 0x7FF0000000000000ULL
+#define LEPT_DECIMAL_MAX_DIGITS 780
+#define LEPT_BIGNUM_LIMBS 288
+
+/* 10^0 ~ 10^22 都能被 double 精确表示 */
+static const double lept_exact_pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* 5^q（q = LEPT_POW5_MIN..LEPT_POW5_MAX）规格化到最高位为 1 的 128 位近似，
+ * q >= 0 时截断，q < 0 时为 2^b / 5^-q 向上取整后截断 */
+static const uint64_t lept_pow5_128[][2] = {
+	{ 0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL }, /* 5^-342 */
+	{ 0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL }, /* 5^-341 */
+	{ 0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL }, /* 5^-340 */
+	{ 0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL }, /* 5^-339 */
+	{ 0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL }, /* 5^-338 */
+	{ 0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL }, /* 5^-337 */
+	{ 0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL }, /* 5^-336 */
+	{ 0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL }, /* 5^-335 */
+	{ 0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL }, /* 5^-334 */
+	{ 0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL }, /* 5^-333 */
+	{ 0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL }, /* 5^-332 */
+	{ 0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL }, /* 5^-331 */
+	{ 0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL }, /* 5^-330 */
+	{ 0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL }, /* 5^-329 */
+	{ 0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL }, /* 5^-328 */
+	{ 0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL }, /* 5^-327 */
+	{ 0x84A57695FE98746DULL, 0x014BB630F7604B57ULL }, /* 5^-326 */
+	{ 0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL }, /* 5^-325 */
+	{ 0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL }, /* 5^-324 */
+	{ 0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL }, /* 5^-323 */
+	{ 0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL }, /* 5^-322 */
+	{ 0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL }, /* 5^-321 */
+	{ 0xFD00B897478238D0ULL, 0x8920B098955522B4ULL }, /* 5^-320 */
+	{ 0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL }, /* 5^-319 */
+	{ 0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL }, /* 5^-318 */
+	{ 0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL }, /* 5^-317 */
+	{ 0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL }, /* 5^-316 */
+	{ 0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL }, /* 5^-315 */
+	{ 0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL }, /* 5^-314 */
+	{ 0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL }, /* 5^-313 */
+	{ 0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL }, /* 5^-312 */
+	{ 0xEBA09271E88D976BULL, 0xF7864A44C633682EULL }, /* 5^-311 */
+	{ 0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL }, /* 5^-310 */
+	{ 0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL }, /* 5^-309 */
+	{ 0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL }, /* 5^-308 */
+	{ 0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL }, /* 5^-307 */
+	{ 0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL }, /* 5^-306 */
+	{ 0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL }, /* 5^-305 */
+	{ 0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL }, /* 5^-304 */
+	{ 0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL }, /* 5^-303 */
+	{ 0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL }, /* 5^-302 */
+	{ 0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL }, /* 5^-301 */
+	{ 0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL }, /* 5^-300 */
+	{ 0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL }, /* 5^-299 */
+	{ 0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL }, /* 5^-298 */
+	{ 0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL }, /* 5^-297 */
+	{ 0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL }, /* 5^-296 */
+	{ 0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL }, /* 5^-295 */
+	{ 0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL }, /* 5^-294 */
+	{ 0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL }, /* 5^-293 */
+	{ 0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL }, /* 5^-292 */
+	{ 0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL }, /* 5^-291 */
+	{ 0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL }, /* 5^-290 */
+	{ 0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL }, /* 5^-289 */
+	{ 0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL }, /* 5^-288 */
+	{ 0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL }, /* 5^-287 */
+	{ 0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL }, /* 5^-286 */
+	{ 0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL }, /* 5^-285 */
+	{ 0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL }, /* 5^-284 */
+	{ 0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL }, /* 5^-283 */
+	{ 0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL }, /* 5^-282 */
+	{ 0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL }, /* 5^-281 */
+	{ 0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL }, /* 5^-280 */
+	{ 0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL }, /* 5^-279 */
+	{ 0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL }, /* 5^-278 */
+	{ 0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL }, /* 5^-277 */
+	{ 0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL }, /* 5^-276 */
+	{ 0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL }, /* 5^-275 */
+	{ 0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL }, /* 5^-274 */
+	{ 0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL }, /* 5^-273 */
+	{ 0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL }, /* 5^-272 */
+	{ 0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL }, /* 5^-271 */
+	{ 0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL }, /* 5^-270 */
+	{ 0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL }, /* 5^-269 */
+	{ 0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL }, /* 5^-268 */
+	{ 0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL }, /* 5^-267 */
+	{ 0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL }, /* 5^-266 */
+	{ 0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL }, /* 5^-265 */
+	{ 0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL }, /* 5^-264 */
+	{ 0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL }, /* 5^-263 */
+	{ 0xC987434744AC874EULL, 0xA327FFB266B56220ULL }, /* 5^-262 */
+	{ 0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL }, /* 5^-261 */
+	{ 0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL }, /* 5^-260 */
+	{ 0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL }, /* 5^-259 */
+	{ 0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL }, /* 5^-258 */
+	{ 0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL }, /* 5^-257 */
+	{ 0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL }, /* 5^-256 */
+	{ 0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL }, /* 5^-255 */
+	{ 0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL }, /* 5^-254 */
+	{ 0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL }, /* 5^-253 */
+	{ 0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL }, /* 5^-252 */
+	{ 0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL }, /* 5^-251 */
+	{ 0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL }, /* 5^-250 */
+	{ 0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL }, /* 5^-249 */
+	{ 0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL }, /* 5^-248 */
+	{ 0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL }, /* 5^-247 */
+	{ 0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL }, /* 5^-246 */
+	{ 0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL }, /* 5^-245 */
+	{ 0xAECC49914078536DULL, 0x58FAE9F773886E18ULL }, /* 5^-244 */
+	{ 0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL }, /* 5^-243 */
+	{ 0x888F99797A5E012DULL, 0x6D8406C952429603ULL }, /* 5^-242 */
+	{ 0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL }, /* 5^-241 */
+	{ 0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL }, /* 5^-240 */
+	{ 0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL }, /* 5^-239 */
+	{ 0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL }, /* 5^-238 */
+	{ 0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL }, /* 5^-237 */
+	{ 0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL }, /* 5^-236 */
+	{ 0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL }, /* 5^-235 */
+	{ 0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL }, /* 5^-234 */
+	{ 0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL }, /* 5^-233 */
+	{ 0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL }, /* 5^-232 */
+	{ 0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL }, /* 5^-231 */
+	{ 0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL }, /* 5^-230 */
+	{ 0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL }, /* 5^-229 */
+	{ 0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL }, /* 5^-228 */
+	{ 0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL }, /* 5^-227 */
+	{ 0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL }, /* 5^-226 */
+	{ 0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL }, /* 5^-225 */
+	{ 0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL }, /* 5^-224 */
+	{ 0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL }, /* 5^-223 */
+	{ 0xB913179899F68584ULL, 0x28E2557B59846E3FULL }, /* 5^-222 */
+	{ 0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL }, /* 5^-221 */
+	{ 0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL }, /* 5^-220 */
+	{ 0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL }, /* 5^-219 */
+	{ 0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL }, /* 5^-218 */
+	{ 0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL }, /* 5^-217 */
+	{ 0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL }, /* 5^-216 */
+	{ 0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL }, /* 5^-215 */
+	{ 0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL }, /* 5^-214 */
+	{ 0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL }, /* 5^-213 */
+	{ 0xD77485CB25823AC7ULL, 0x7D633293366B828BULL }, /* 5^-212 */
+	{ 0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL }, /* 5^-211 */
+	{ 0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL }, /* 5^-210 */
+	{ 0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL }, /* 5^-209 */
+	{ 0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL }, /* 5^-208 */
+	{ 0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL }, /* 5^-207 */
+	{ 0xCD795BE870516656ULL, 0x67902E276C921F8BULL }, /* 5^-206 */
+	{ 0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL }, /* 5^-205 */
+	{ 0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL }, /* 5^-204 */
+	{ 0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL }, /* 5^-203 */
+	{ 0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL }, /* 5^-202 */
+	{ 0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL }, /* 5^-201 */
+	{ 0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL }, /* 5^-200 */
+	{ 0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL }, /* 5^-199 */
+	{ 0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL }, /* 5^-198 */
+	{ 0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL }, /* 5^-197 */
+	{ 0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL }, /* 5^-196 */
+	{ 0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL }, /* 5^-195 */
+	{ 0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL }, /* 5^-194 */
+	{ 0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL }, /* 5^-193 */
+	{ 0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL }, /* 5^-192 */
+	{ 0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL }, /* 5^-191 */
+	{ 0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL }, /* 5^-190 */
+	{ 0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL }, /* 5^-189 */
+	{ 0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL }, /* 5^-188 */
+	{ 0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL }, /* 5^-187 */
+	{ 0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL }, /* 5^-186 */
+	{ 0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL }, /* 5^-185 */
+	{ 0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL }, /* 5^-184 */
+	{ 0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL }, /* 5^-183 */
+	{ 0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL }, /* 5^-182 */
+	{ 0xD47487CC8470652BULL, 0x7647C3200069671FULL }, /* 5^-181 */
+	{ 0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL }, /* 5^-180 */
+	{ 0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL }, /* 5^-179 */
+	{ 0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL }, /* 5^-178 */
+	{ 0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL }, /* 5^-177 */
+	{ 0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL }, /* 5^-176 */
+	{ 0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL }, /* 5^-175 */
+	{ 0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL }, /* 5^-174 */
+	{ 0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL }, /* 5^-173 */
+	{ 0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL }, /* 5^-172 */
+	{ 0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL }, /* 5^-171 */
+	{ 0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL }, /* 5^-170 */
+	{ 0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL }, /* 5^-169 */
+	{ 0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL }, /* 5^-168 */
+	{ 0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL }, /* 5^-167 */
+	{ 0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL }, /* 5^-166 */
+	{ 0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL }, /* 5^-165 */
+	{ 0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL }, /* 5^-164 */
+	{ 0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL }, /* 5^-163 */
+	{ 0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL }, /* 5^-162 */
+	{ 0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL }, /* 5^-161 */
+	{ 0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL }, /* 5^-160 */
+	{ 0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL }, /* 5^-159 */
+	{ 0x8C974F7383725573ULL, 0x1E414218C73A13FBULL }, /* 5^-158 */
+	{ 0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL }, /* 5^-157 */
+	{ 0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL }, /* 5^-156 */
+	{ 0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL }, /* 5^-155 */
+	{ 0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL }, /* 5^-154 */
+	{ 0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL }, /* 5^-153 */
+	{ 0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL }, /* 5^-152 */
+	{ 0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL }, /* 5^-151 */
+	{ 0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL }, /* 5^-150 */
+	{ 0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL }, /* 5^-149 */
+	{ 0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL }, /* 5^-148 */
+	{ 0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL }, /* 5^-147 */
+	{ 0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL }, /* 5^-146 */
+	{ 0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL }, /* 5^-145 */
+	{ 0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL }, /* 5^-144 */
+	{ 0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL }, /* 5^-143 */
+	{ 0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL }, /* 5^-142 */
+	{ 0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL }, /* 5^-141 */
+	{ 0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL }, /* 5^-140 */
+	{ 0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL }, /* 5^-139 */
+	{ 0xBE89523386091465ULL, 0xF6BBB397F1135823ULL }, /* 5^-138 */
+	{ 0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL }, /* 5^-137 */
+	{ 0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL }, /* 5^-136 */
+	{ 0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL }, /* 5^-135 */
+	{ 0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL }, /* 5^-134 */
+	{ 0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL }, /* 5^-133 */
+	{ 0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL }, /* 5^-132 */
+	{ 0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL }, /* 5^-131 */
+	{ 0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL }, /* 5^-130 */
+	{ 0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL }, /* 5^-129 */
+	{ 0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL }, /* 5^-128 */
+	{ 0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL }, /* 5^-127 */
+	{ 0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL }, /* 5^-126 */
+	{ 0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL }, /* 5^-125 */
+	{ 0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL }, /* 5^-124 */
+	{ 0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL }, /* 5^-123 */
+	{ 0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL }, /* 5^-122 */
+	{ 0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL }, /* 5^-121 */
+	{ 0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL }, /* 5^-120 */
+	{ 0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL }, /* 5^-119 */
+	{ 0x811CCC668829B887ULL, 0x0806357D5A3F525FULL }, /* 5^-118 */
+	{ 0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL }, /* 5^-117 */
+	{ 0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL }, /* 5^-116 */
+	{ 0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL }, /* 5^-115 */
+	{ 0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL }, /* 5^-114 */
+	{ 0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL }, /* 5^-113 */
+	{ 0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL }, /* 5^-112 */
+	{ 0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL }, /* 5^-111 */
+	{ 0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL }, /* 5^-110 */
+	{ 0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL }, /* 5^-109 */
+	{ 0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL }, /* 5^-108 */
+	{ 0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL }, /* 5^-107 */
+	{ 0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL }, /* 5^-106 */
+	{ 0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL }, /* 5^-105 */
+	{ 0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL }, /* 5^-104 */
+	{ 0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL }, /* 5^-103 */
+	{ 0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL }, /* 5^-102 */
+	{ 0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL }, /* 5^-101 */
+	{ 0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL }, /* 5^-100 */
+	{ 0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL }, /* 5^-99 */
+	{ 0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL }, /* 5^-98 */
+	{ 0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL }, /* 5^-97 */
+	{ 0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL }, /* 5^-96 */
+	{ 0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL }, /* 5^-95 */
+	{ 0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL }, /* 5^-94 */
+	{ 0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL }, /* 5^-93 */
+	{ 0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL }, /* 5^-92 */
+	{ 0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL }, /* 5^-91 */
+	{ 0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL }, /* 5^-90 */
+	{ 0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL }, /* 5^-89 */
+	{ 0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL }, /* 5^-88 */
+	{ 0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL }, /* 5^-87 */
+	{ 0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL }, /* 5^-86 */
+	{ 0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL }, /* 5^-85 */
+	{ 0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL }, /* 5^-84 */
+	{ 0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL }, /* 5^-83 */
+	{ 0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL }, /* 5^-82 */
+	{ 0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL }, /* 5^-81 */
+	{ 0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL }, /* 5^-80 */
+	{ 0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL }, /* 5^-79 */
+	{ 0xED246723473E3813ULL, 0x290123E9AAB23B68ULL }, /* 5^-78 */
+	{ 0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL }, /* 5^-77 */
+	{ 0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL }, /* 5^-76 */
+	{ 0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL }, /* 5^-75 */
+	{ 0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL }, /* 5^-74 */
+	{ 0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL }, /* 5^-73 */
+	{ 0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL }, /* 5^-72 */
+	{ 0x8D590723948A535FULL, 0x579C487E5A38AD0EULL }, /* 5^-71 */
+	{ 0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL }, /* 5^-70 */
+	{ 0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL }, /* 5^-69 */
+	{ 0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL }, /* 5^-68 */
+	{ 0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL }, /* 5^-67 */
+	{ 0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL }, /* 5^-66 */
+	{ 0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL }, /* 5^-65 */
+	{ 0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL }, /* 5^-64 */
+	{ 0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL }, /* 5^-63 */
+	{ 0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL }, /* 5^-62 */
+	{ 0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL }, /* 5^-61 */
+	{ 0xCDB02555653131B6ULL, 0x3792F412CB06794DULL }, /* 5^-60 */
+	{ 0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL }, /* 5^-59 */
+	{ 0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL }, /* 5^-58 */
+	{ 0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL }, /* 5^-57 */
+	{ 0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL }, /* 5^-56 */
+	{ 0x9CED737BB6C4183DULL, 0x55464DD69685606BULL }, /* 5^-55 */
+	{ 0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL }, /* 5^-54 */
+	{ 0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL }, /* 5^-53 */
+	{ 0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL }, /* 5^-52 */
+	{ 0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL }, /* 5^-51 */
+	{ 0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL }, /* 5^-50 */
+	{ 0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL }, /* 5^-49 */
+	{ 0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL }, /* 5^-48 */
+	{ 0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL }, /* 5^-47 */
+	{ 0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL }, /* 5^-46 */
+	{ 0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL }, /* 5^-45 */
+	{ 0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL }, /* 5^-44 */
+	{ 0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL }, /* 5^-43 */
+	{ 0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL }, /* 5^-42 */
+	{ 0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL }, /* 5^-41 */
+	{ 0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL }, /* 5^-40 */
+	{ 0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL }, /* 5^-39 */
+	{ 0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL }, /* 5^-38 */
+	{ 0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL }, /* 5^-37 */
+	{ 0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL }, /* 5^-36 */
+	{ 0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL }, /* 5^-35 */
+	{ 0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL }, /* 5^-34 */
+	{ 0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL }, /* 5^-33 */
+	{ 0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL }, /* 5^-32 */
+	{ 0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL }, /* 5^-31 */
+	{ 0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL }, /* 5^-30 */
+	{ 0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL }, /* 5^-29 */
+	{ 0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL }, /* 5^-28 */
+	{ 0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL }, /* 5^-27 */
+	{ 0xC612062576589DDAULL, 0x95364AFE032A819EULL }, /* 5^-26 */
+	{ 0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL }, /* 5^-25 */
+	{ 0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL }, /* 5^-24 */
+	{ 0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL }, /* 5^-23 */
+	{ 0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL }, /* 5^-22 */
+	{ 0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL }, /* 5^-21 */
+	{ 0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL }, /* 5^-20 */
+	{ 0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL }, /* 5^-19 */
+	{ 0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL }, /* 5^-18 */
+	{ 0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL }, /* 5^-17 */
+	{ 0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL }, /* 5^-16 */
+	{ 0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL }, /* 5^-15 */
+	{ 0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL }, /* 5^-14 */
+	{ 0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL }, /* 5^-13 */
+	{ 0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL }, /* 5^-12 */
+	{ 0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL }, /* 5^-11 */
+	{ 0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL }, /* 5^-10 */
+	{ 0x89705F4136B4A597ULL, 0x31680A88F8953031ULL }, /* 5^-9 */
+	{ 0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL }, /* 5^-8 */
+	{ 0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL }, /* 5^-7 */
+	{ 0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL }, /* 5^-6 */
+	{ 0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL }, /* 5^-5 */
+	{ 0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL }, /* 5^-4 */
+	{ 0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL }, /* 5^-3 */
+	{ 0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL }, /* 5^-2 */
+	{ 0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL }, /* 5^-1 */
+	{ 0x8000000000000000ULL, 0x0000000000000000ULL }, /* 5^0 */
+	{ 0xA000000000000000ULL, 0x0000000000000000ULL }, /* 5^1 */
+	{ 0xC800000000000000ULL, 0x0000000000000000ULL }, /* 5^2 */
+	{ 0xFA00000000000000ULL, 0x0000000000000000ULL }, /* 5^3 */
+	{ 0x9C40000000000000ULL, 0x0000000000000000ULL }, /* 5^4 */
+	{ 0xC350000000000000ULL, 0x0000000000000000ULL }, /* 5^5 */
+	{ 0xF424000000000000ULL, 0x0000000000000000ULL }, /* 5^6 */
+	{ 0x9896800000000000ULL, 0x0000000000000000ULL }, /* 5^7 */
+	{ 0xBEBC200000000000ULL, 0x0000000000000000ULL }, /* 5^8 */
+	{ 0xEE6B280000000000ULL, 0x0000000000000000ULL }, /* 5^9 */
+	{ 0x9502F90000000000ULL, 0x0000000000000000ULL }, /* 5^10 */
+	{ 0xBA43B74000000000ULL, 0x0000000000000000ULL }, /* 5^11 */
+	{ 0xE8D4A51000000000ULL, 0x0000000000000000ULL }, /* 5^12 */
+	{ 0x9184E72A00000000ULL, 0x0000000000000000ULL }, /* 5^13 */
+	{ 0xB5E620F480000000ULL, 0x0000000000000000ULL }, /* 5^14 */
+	{ 0xE35FA931A0000000ULL, 0x0000000000000000ULL }, /* 5^15 */
+	{ 0x8E1BC9BF04000000ULL, 0x0000000000000000ULL }, /* 5^16 */
+	{ 0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL }, /* 5^17 */
+	{ 0xDE0B6B3A76400000ULL, 0x0000000000000000ULL }, /* 5^18 */
+	{ 0x8AC7230489E80000ULL, 0x0000000000000000ULL }, /* 5^19 */
+	{ 0xAD78EBC5AC620000ULL, 0x0000000000000000ULL }, /* 5^20 */
+	{ 0xD8D726B7177A8000ULL, 0x0000000000000000ULL }, /* 5^21 */
+	{ 0x878678326EAC9000ULL, 0x0000000000000000ULL }, /* 5^22 */
+	{ 0xA968163F0A57B400ULL, 0x0000000000000000ULL }, /* 5^23 */
+	{ 0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL }, /* 5^24 */
+	{ 0x84595161401484A0ULL, 0x0000000000000000ULL }, /* 5^25 */
+	{ 0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL }, /* 5^26 */
+	{ 0xCECB8F27F4200F3AULL, 0x0000000000000000ULL }, /* 5^27 */
+	{ 0x813F3978F8940984ULL, 0x4000000000000000ULL }, /* 5^28 */
+	{ 0xA18F07D736B90BE5ULL, 0x5000000000000000ULL }, /* 5^29 */
+	{ 0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL }, /* 5^30 */
+	{ 0xFC6F7C4045812296ULL, 0x4D00000000000000ULL }, /* 5^31 */
+	{ 0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL }, /* 5^32 */
+	{ 0xC5371912364CE305ULL, 0x6C28000000000000ULL }, /* 5^33 */
+	{ 0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL }, /* 5^34 */
+	{ 0x9A130B963A6C115CULL, 0x3C7F400000000000ULL }, /* 5^35 */
+	{ 0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL }, /* 5^36 */
+	{ 0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL }, /* 5^37 */
+	{ 0x96769950B50D88F4ULL, 0x1314448000000000ULL }, /* 5^38 */
+	{ 0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL }, /* 5^39 */
+	{ 0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL }, /* 5^40 */
+	{ 0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL }, /* 5^41 */
+	{ 0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL }, /* 5^42 */
+	{ 0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL }, /* 5^43 */
+	{ 0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL }, /* 5^44 */
+	{ 0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL }, /* 5^45 */
+	{ 0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL }, /* 5^46 */
+	{ 0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL }, /* 5^47 */
+	{ 0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL }, /* 5^48 */
+	{ 0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL }, /* 5^49 */
+	{ 0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL }, /* 5^50 */
+	{ 0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL }, /* 5^51 */
+	{ 0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL }, /* 5^52 */
+	{ 0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL }, /* 5^53 */
+	{ 0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL }, /* 5^54 */
+	{ 0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL }, /* 5^55 */
+	{ 0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL }, /* 5^56 */
+	{ 0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL }, /* 5^57 */
+	{ 0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL }, /* 5^58 */
+	{ 0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL }, /* 5^59 */
+	{ 0x9F4F2726179A2245ULL, 0x01D762422C946590ULL }, /* 5^60 */
+	{ 0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL }, /* 5^61 */
+	{ 0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL }, /* 5^62 */
+	{ 0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL }, /* 5^63 */
+	{ 0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL }, /* 5^64 */
+	{ 0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL }, /* 5^65 */
+	{ 0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL }, /* 5^66 */
+	{ 0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL }, /* 5^67 */
+	{ 0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL }, /* 5^68 */
+	{ 0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL }, /* 5^69 */
+	{ 0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL }, /* 5^70 */
+	{ 0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL }, /* 5^71 */
+	{ 0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL }, /* 5^72 */
+	{ 0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL }, /* 5^73 */
+	{ 0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL }, /* 5^74 */
+	{ 0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL }, /* 5^75 */
+	{ 0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL }, /* 5^76 */
+	{ 0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL }, /* 5^77 */
+	{ 0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL }, /* 5^78 */
+	{ 0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL }, /* 5^79 */
+	{ 0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL }, /* 5^80 */
+	{ 0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL }, /* 5^81 */
+	{ 0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL }, /* 5^82 */
+	{ 0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL }, /* 5^83 */
+	{ 0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL }, /* 5^84 */
+	{ 0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL }, /* 5^85 */
+	{ 0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL }, /* 5^86 */
+	{ 0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL }, /* 5^87 */
+	{ 0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL }, /* 5^88 */
+	{ 0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL }, /* 5^89 */
+	{ 0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL }, /* 5^90 */
+	{ 0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL }, /* 5^91 */
+	{ 0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL }, /* 5^92 */
+	{ 0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL }, /* 5^93 */
+	{ 0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL }, /* 5^94 */
+	{ 0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL }, /* 5^95 */
+	{ 0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL }, /* 5^96 */
+	{ 0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL }, /* 5^97 */
+	{ 0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL }, /* 5^98 */
+	{ 0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL }, /* 5^99 */
+	{ 0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL }, /* 5^100 */
+	{ 0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL }, /* 5^101 */
+	{ 0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL }, /* 5^102 */
+	{ 0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL }, /* 5^103 */
+	{ 0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL }, /* 5^104 */
+	{ 0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL }, /* 5^105 */
+	{ 0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL }, /* 5^106 */
+	{ 0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL }, /* 5^107 */
+	{ 0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL }, /* 5^108 */
+	{ 0x884134FE908658B2ULL, 0x3109058D147FDCDDULL }, /* 5^109 */
+	{ 0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL }, /* 5^110 */
+	{ 0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL }, /* 5^111 */
+	{ 0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL }, /* 5^112 */
+	{ 0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL }, /* 5^113 */
+	{ 0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL }, /* 5^114 */
+	{ 0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL }, /* 5^115 */
+	{ 0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL }, /* 5^116 */
+	{ 0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL }, /* 5^117 */
+	{ 0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL }, /* 5^118 */
+	{ 0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL }, /* 5^119 */
+	{ 0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL }, /* 5^120 */
+	{ 0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL }, /* 5^121 */
+	{ 0x9AE757596946075FULL, 0x3375788DE9B06958ULL }, /* 5^122 */
+	{ 0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL }, /* 5^123 */
+	{ 0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL }, /* 5^124 */
+	{ 0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL }, /* 5^125 */
+	{ 0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL }, /* 5^126 */
+	{ 0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL }, /* 5^127 */
+	{ 0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL }, /* 5^128 */
+	{ 0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL }, /* 5^129 */
+	{ 0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL }, /* 5^130 */
+	{ 0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL }, /* 5^131 */
+	{ 0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL }, /* 5^132 */
+	{ 0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL }, /* 5^133 */
+	{ 0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL }, /* 5^134 */
+	{ 0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL }, /* 5^135 */
+	{ 0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL }, /* 5^136 */
+	{ 0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL }, /* 5^137 */
+	{ 0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL }, /* 5^138 */
+	{ 0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL }, /* 5^139 */
+	{ 0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL }, /* 5^140 */
+	{ 0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL }, /* 5^141 */
+	{ 0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL }, /* 5^142 */
+	{ 0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL }, /* 5^143 */
+	{ 0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL }, /* 5^144 */
+	{ 0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL }, /* 5^145 */
+	{ 0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL }, /* 5^146 */
+	{ 0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL }, /* 5^147 */
+	{ 0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL }, /* 5^148 */
+	{ 0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL }, /* 5^149 */
+	{ 0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL }, /* 5^150 */
+	{ 0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL }, /* 5^151 */
+	{ 0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL }, /* 5^152 */
+	{ 0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL }, /* 5^153 */
+	{ 0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL }, /* 5^154 */
+	{ 0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL }, /* 5^155 */
+	{ 0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL }, /* 5^156 */
+	{ 0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL }, /* 5^157 */
+	{ 0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL }, /* 5^158 */
+	{ 0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL }, /* 5^159 */
+	{ 0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL }, /* 5^160 */
+	{ 0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL }, /* 5^161 */
+	{ 0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL }, /* 5^162 */
+	{ 0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL }, /* 5^163 */
+	{ 0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL }, /* 5^164 */
+	{ 0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL }, /* 5^165 */
+	{ 0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL }, /* 5^166 */
+	{ 0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL }, /* 5^167 */
+	{ 0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL }, /* 5^168 */
+	{ 0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL }, /* 5^169 */
+	{ 0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL }, /* 5^170 */
+	{ 0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL }, /* 5^171 */
+	{ 0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL }, /* 5^172 */
+	{ 0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL }, /* 5^173 */
+	{ 0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL }, /* 5^174 */
+	{ 0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL }, /* 5^175 */
+	{ 0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL }, /* 5^176 */
+	{ 0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL }, /* 5^177 */
+	{ 0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL }, /* 5^178 */
+	{ 0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL }, /* 5^179 */
+	{ 0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL }, /* 5^180 */
+	{ 0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL }, /* 5^181 */
+	{ 0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL }, /* 5^182 */
+	{ 0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL }, /* 5^183 */
+	{ 0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL }, /* 5^184 */
+	{ 0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL }, /* 5^185 */
+	{ 0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL }, /* 5^186 */
+	{ 0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL }, /* 5^187 */
+	{ 0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL }, /* 5^188 */
+	{ 0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL }, /* 5^189 */
+	{ 0x8FA475791A569D10ULL, 0xF96E017D694487BCULL }, /* 5^190 */
+	{ 0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL }, /* 5^191 */
+	{ 0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL }, /* 5^192 */
+	{ 0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL }, /* 5^193 */
+	{ 0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL }, /* 5^194 */
+	{ 0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL }, /* 5^195 */
+	{ 0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL }, /* 5^196 */
+	{ 0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL }, /* 5^197 */
+	{ 0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL }, /* 5^198 */
+	{ 0x85C7056562757456ULL, 0xF6872D5667844E49ULL }, /* 5^199 */
+	{ 0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL }, /* 5^200 */
+	{ 0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL }, /* 5^201 */
+	{ 0x82A45B450226B39CULL, 0xECC0024661173473ULL }, /* 5^202 */
+	{ 0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL }, /* 5^203 */
+	{ 0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL }, /* 5^204 */
+	{ 0xFF290242C83396CEULL, 0x7E67047175A15271ULL }, /* 5^205 */
+	{ 0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL }, /* 5^206 */
+	{ 0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL }, /* 5^207 */
+	{ 0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL }, /* 5^208 */
+	{ 0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL }, /* 5^209 */
+	{ 0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL }, /* 5^210 */
+	{ 0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL }, /* 5^211 */
+	{ 0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL }, /* 5^212 */
+	{ 0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL }, /* 5^213 */
+	{ 0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL }, /* 5^214 */
+	{ 0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL }, /* 5^215 */
+	{ 0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL }, /* 5^216 */
+	{ 0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL }, /* 5^217 */
+	{ 0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL }, /* 5^218 */
+	{ 0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL }, /* 5^219 */
+	{ 0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL }, /* 5^220 */
+	{ 0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL }, /* 5^221 */
+	{ 0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL }, /* 5^222 */
+	{ 0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL }, /* 5^223 */
+	{ 0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL }, /* 5^224 */
+	{ 0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL }, /* 5^225 */
+	{ 0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL }, /* 5^226 */
+	{ 0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL }, /* 5^227 */
+	{ 0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL }, /* 5^228 */
+	{ 0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL }, /* 5^229 */
+	{ 0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL }, /* 5^230 */
+	{ 0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL }, /* 5^231 */
+	{ 0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL }, /* 5^232 */
+	{ 0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL }, /* 5^233 */
+	{ 0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL }, /* 5^234 */
+	{ 0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL }, /* 5^235 */
+	{ 0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL }, /* 5^236 */
+	{ 0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL }, /* 5^237 */
+	{ 0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL }, /* 5^238 */
+	{ 0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL }, /* 5^239 */
+	{ 0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL }, /* 5^240 */
+	{ 0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL }, /* 5^241 */
+	{ 0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL }, /* 5^242 */
+	{ 0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL }, /* 5^243 */
+	{ 0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL }, /* 5^244 */
+	{ 0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL }, /* 5^245 */
+	{ 0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL }, /* 5^246 */
+	{ 0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL }, /* 5^247 */
+	{ 0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL }, /* 5^248 */
+	{ 0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL }, /* 5^249 */
+	{ 0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL }, /* 5^250 */
+	{ 0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL }, /* 5^251 */
+	{ 0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL }, /* 5^252 */
+	{ 0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL }, /* 5^253 */
+	{ 0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL }, /* 5^254 */
+	{ 0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL }, /* 5^255 */
+	{ 0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL }, /* 5^256 */
+	{ 0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL }, /* 5^257 */
+	{ 0x8533285C936B35DEULL, 0xD53A88958F87275FULL }, /* 5^258 */
+	{ 0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL }, /* 5^259 */
+	{ 0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL }, /* 5^260 */
+	{ 0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL }, /* 5^261 */
+	{ 0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL }, /* 5^262 */
+	{ 0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL }, /* 5^263 */
+	{ 0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL }, /* 5^264 */
+	{ 0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL }, /* 5^265 */
+	{ 0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL }, /* 5^266 */
+	{ 0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL }, /* 5^267 */
+	{ 0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL }, /* 5^268 */
+	{ 0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL }, /* 5^269 */
+	{ 0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL }, /* 5^270 */
+	{ 0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL }, /* 5^271 */
+	{ 0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL }, /* 5^272 */
+	{ 0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL }, /* 5^273 */
+	{ 0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL }, /* 5^274 */
+	{ 0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL }, /* 5^275 */
+	{ 0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL }, /* 5^276 */
+	{ 0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL }, /* 5^277 */
+	{ 0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL }, /* 5^278 */
+	{ 0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL }, /* 5^279 */
+	{ 0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL }, /* 5^280 */
+	{ 0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL }, /* 5^281 */
+	{ 0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL }, /* 5^282 */
+	{ 0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL }, /* 5^283 */
+	{ 0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL }, /* 5^284 */
+	{ 0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL }, /* 5^285 */
+	{ 0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL }, /* 5^286 */
+	{ 0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL }, /* 5^287 */
+	{ 0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL }, /* 5^288 */
+	{ 0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL }, /* 5^289 */
+	{ 0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL }, /* 5^290 */
+	{ 0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL }, /* 5^291 */
+	{ 0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL }, /* 5^292 */
+	{ 0xA0555E361951C366ULL, 0xD7E105BCC332621FULL }, /* 5^293 */
+	{ 0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL }, /* 5^294 */
+	{ 0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL }, /* 5^295 */
+	{ 0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL }, /* 5^296 */
+	{ 0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL }, /* 5^297 */
+	{ 0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL }, /* 5^298 */
+	{ 0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL }, /* 5^299 */
+	{ 0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL }, /* 5^300 */
+	{ 0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL }, /* 5^301 */
+	{ 0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL }, /* 5^302 */
+	{ 0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL }, /* 5^303 */
+	{ 0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL }, /* 5^304 */
+	{ 0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL }, /* 5^305 */
+	{ 0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL }, /* 5^306 */
+	{ 0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL }, /* 5^307 */
+	{ 0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL }, /* 5^308 */
+	{ 0xB201833B35D63F73ULL, 0x2CD2CC6551E513DAULL }, /* 5^309 */
+	{ 0xDE81E40A034BCF4FULL, 0xF8077F7EA65E58D1ULL }, /* 5^310 */
+	{ 0x8B112E86420F6191ULL, 0xFB04AFAF27FAF782ULL }, /* 5^311 */
+	{ 0xADD57A27D29339F6ULL, 0x79C5DB9AF1F9B563ULL }, /* 5^312 */
+	{ 0xD94AD8B1C7380874ULL, 0x18375281AE7822BCULL }, /* 5^313 */
+	{ 0x87CEC76F1C830548ULL, 0x8F2293910D0B15B5ULL }, /* 5^314 */
+	{ 0xA9C2794AE3A3C69AULL, 0xB2EB3875504DDB22ULL }, /* 5^315 */
+	{ 0xD433179D9C8CB841ULL, 0x5FA60692A46151EBULL }, /* 5^316 */
+	{ 0x849FEEC281D7F328ULL, 0xDBC7C41BA6BCD333ULL }, /* 5^317 */
+	{ 0xA5C7EA73224DEFF3ULL, 0x12B9B522906C0800ULL }, /* 5^318 */
+	{ 0xCF39E50FEAE16BEFULL, 0xD768226B34870A00ULL }, /* 5^319 */
+	{ 0x81842F29F2CCE375ULL, 0xE6A1158300D46640ULL }, /* 5^320 */
+	{ 0xA1E53AF46F801C53ULL, 0x60495AE3C1097FD0ULL }, /* 5^321 */
+	{ 0xCA5E89B18B602368ULL, 0x385BB19CB14BDFC4ULL }, /* 5^322 */
+	{ 0xFCF62C1DEE382C42ULL, 0x46729E03DD9ED7B5ULL }, /* 5^323 */
+	{ 0x9E19DB92B4E31BA9ULL, 0x6C07A2C26A8346D1ULL }, /* 5^324 */
+};
+
 #define ISHEX(ch) (((ch) >= '0' && (ch) <= '9') || ((ch) >= 'a' && (ch) <= 'f') || ((ch) >= 'A' && (ch) <= 'F'))
 
 #ifndef LEPT_PARSE_STACK_INIT_SIZE
@@ -53,10 +1055,28 @@ static void lept_stringify_string(lept_context *, const char *, size_t);
 #define LEPT_PARSE_STRINGIFY_INIT_SIZE 256
 #endif
 
-#define PUTC(c, ch) \
-	do {  \
-		* (char *)lept_context_push(c, sizeof(char)) = (ch); \
-} while(0)
+/* 校验时不超过这个深度就不分配内存，见 lept_skip_validate()；须是 64 的倍数 */
+#ifndef LEPT_VALIDATE_STACK_DEPTH
+#define LEPT_VALIDATE_STACK_DEPTH 4096
+#endif
+
+/* lept_parser / lept_writer 在两次调用之间默认最多保留的缓冲区大小（字节） */
+#ifndef LEPT_RETAIN_SIZE
+#define LEPT_RETAIN_SIZE (1024 * 1024)
+#endif
+
+/* 短于此长度的字符串输出时按最坏情况预留，不先数转义 */
+#ifndef LEPT_ESCAPE_COUNT_SIZE
+#define LEPT_ESCAPE_COUNT_SIZE 32
+#endif
+
+/* 一个数字最多占 32 字节，sink 的缓冲区不能比这更小 */
+#ifndef LEPT_STRINGIFY_SINK_MIN_SIZE
+#define LEPT_STRINGIFY_SINK_MIN_SIZE 64
+#endif
+
+/* 分配失败时返回 0，栈保持原样 */
+#define PUTC(c, ch) lept_context_putc(c, ch)
 // 这段理解了很久,假设lept_context_push返回一个char指针p, 再另*p = ch
 /*void PUTC(lept_context *c, char ch) {
 //	*(char *)lept_context_push(c, sizeof(char)) = (ch);
@@ -67,7 +1087,10 @@ static void lept_stringify_string(lept_context *, const char *, size_t);
 
 #define STRING_ERROR(ret) do { c->top = head; return ret; } while(0)
 
-#define PUTS(c, s, len) memcpy(lept_context_push(c, len), s, len)
+#define PUTS(c, s, len) lept_context_puts(c, s, len)
+
+/* 未设置的回调视为继续；回调返回 0 时中止解析 */
+#define SAX_EVENT(h, event, args) ((h)->event == NULL || (h)->event args)
 
 int lept_get_type(const lept_value *v) {
 	assert(v != NULL);
@@ -75,565 +1098,4002 @@ int lept_get_type(const lept_value *v) {
 }
 
 int lept_parse(lept_value *v, char *json) {
-	lept_context c;
-	int ret = 0;
+	return lept_parse_ex(v, json, NULL);
+}
+
+/* 所有字符串、键、元素块都从 arena 分配，lept_free 对这些值是 O(1) 的空操作，
+ * 整棵树随 lept_arena_reset()/lept_arena_free() 一次性释放 */
+int lept_parse_arena(lept_value *v, char *json, lept_arena *a) {
+	lept_parse_options opt;
+	assert(a != NULL);
+	opt.flags = 0;
+	opt.arena = a;
+	opt.symtab = NULL;
+	opt.max_depth = 0;
+	opt.stats = NULL;
+	opt.allocator = NULL;
+	opt.offset = NULL;
+	return lept_parse_ex(v, json, &opt);
+}
+
+/* 转义在 json 缓冲区内原地解码，字符串值和键直接指向缓冲区并以 '\0' 结尾，省去栈上解码和 malloc 复制。
+ * 调用者须在整棵树的生命周期内保持缓冲区有效；解析失败时缓冲区内容不确定 */
+int lept_parse_insitu(lept_value *v, char *json) {
+	lept_parse_options opt;
+	opt.flags = LEPT_PARSE_FLAG_INSITU;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 0;
+	opt.stats = NULL;
+	opt.allocator = NULL;
+	opt.offset = NULL;
+	return lept_parse_ex(v, json, &opt);
+}
+
+/* opt 为 NULL 时等同于 lept_parse() */
+int lept_parse_ex(lept_value *v, char *json, const lept_parse_options *opt) {
+	assert(json != NULL);
+	return lept_parse_range(v, json, json + strlen(json), opt);
+}
+
+/* 只读取 json[0, len)，不要求也不检查结尾的 '\0'；范围内出现的 '\0' 是非法字符 */
+int lept_parse_n(lept_value *v, const char *json, size_t len) {
+	assert(json != NULL || len == 0);
+	return lept_parse_range(v, json, json + len, NULL);
+}
+
+/* 只解码根容器这一层：标量成员直接解码，嵌套的数组、对象和字符串只记下在 json 中的范围，
+ * 第一次被 lept_get_string()、lept_get_array_size()、lept_get_object_value() 等访问时才解码（同样只解码一层）。
+ * json 须在整棵树的生命周期内保持有效，多个线程不能同时读取同一棵惰性树。
+ * 默认只检查字符串和括号是否完整，子树中的其他语法错误要到解码时才发现：这时节点保持惰性，
+ * 访问函数返回 NULL、0 或 LEPT_KEY_NOT_EXIST，lept_lazy_decode() 返回错误码；
+ * flags 含 LEPT_PARSE_FLAG_VALIDATE 时整个输入都按 lept_parse_n() 的标准校验，只是不解码。
+ * 需要 arena、驻留表、单独的分配器、max_depth 或原地解析时改用 lept_parse_ex() 加 LEPT_PARSE_FLAG_LAZY，
+ * 之后每一层解码都沿用这些选项 */
+int lept_parse_lazy(lept_value *v, const char *json, size_t len, unsigned flags) {
+	lept_parse_options opt;
+	assert(json != NULL || len == 0);
+	assert(!(flags & LEPT_PARSE_FLAG_INSITU));
+	opt.flags = flags | LEPT_PARSE_FLAG_LAZY;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 0;
+	opt.stats = NULL;
+	opt.allocator = NULL;
+	opt.offset = NULL;
+	return lept_parse_range(v, json, json + len, &opt);
+}
+
+/* 解码惰性节点 v 这一层（不是惰性节点时什么都不做），返回 LEPT_PARSE_OK 或解码出错的错误码。
+ * 出错时 v 保持惰性，可以据此区分解码失败与真正的空字符串、空数组和空对象 */
+int lept_lazy_decode(const lept_value *v) {
 	assert(v != NULL);
+	return v->flags & LEPT_VALUE_LAZY ? lept_lazy_load((lept_value *)v) : LEPT_PARSE_OK;
+}
+
+/* 只校验 json[0, len) 是否是合法的 JSON，语法与 lept_parse_n() 完全相同，返回值也相同（包括 LEPT_PARSE_NUMBER_TOO_BIG），
+ * 但不构造任何值，不解码字符串；嵌套不超过 LEPT_VALIDATE_STACK_DEPTH 层时不分配内存。
+ * flags 只接受 LEPT_PARSE_FLAG_VALIDATE_UTF8，含义与解析时相同。
+ * offset 非 NULL 时写入出错的字节位置（数字和字面量为其开头），成功时为 len */
+int lept_validate(const char *json, size_t len, unsigned flags, size_t *offset) {
+	lept_context c;
+	int ret;
+	assert(json != NULL || len == 0);
+	lept_simd_init();
 	c.json = json;
+	c.end = json + len;
 	c.stack = NULL;
 	c.size = c.top = 0;
-	lept_init(v);
-	v->type = LEPT_VOID;
+	c.frames = NULL;
+	c.frames_size = 0;
+	c.max_depth = 0;
+	c.arena = NULL;
+	c.symtab = NULL;
+	c.stats = NULL;
+	c.allocator = &lept_global_allocator;
+	assert(!(flags & ~LEPT_PARSE_FLAG_VALIDATE_UTF8));
+	c.flags = flags;
 	lept_parse_whitespace(&c);
-	if((ret = lept_parse_value(&c, v)) == LEPT_PARSE_OK) {
+	if ((ret = lept_skip_validate(&c, 0)) == LEPT_PARSE_OK) {
 		lept_parse_whitespace(&c);
-		if (*c.json != '\0') {
+		if (c.json != c.end)
 			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
-			v->type = LEPT_VOID;
-		}
 	}
-	if(c.top != 0);
-		free(c.stack);
+	assert(c.stack == NULL);
+	if (offset != NULL)
+		*offset = (size_t)(c.json - json);
 	return ret;
 }
 
-static int lept_parse_value(lept_context *c, lept_value *v) {
-	switch (*c->json) {
-		case 'n': return lept_parse_literal(c, v, "null", LEPT_NULL);
-		case 't': return lept_parse_literal(c, v, "true", LEPT_TRUE);
-		case 'f': return lept_parse_literal(c, v, "false", LEPT_FALSE);
-		case '\0': return LEPT_PARSE_EXPECT_VALUE;
-		case '\"': return lept_parse_string(c, v);
-		case '[': return lept_parse_array(c, v);
-		case '{': return lept_parse_object(c, v);
-		default: return lept_parse_number(c, v);
-	}
+static int lept_parse_range(lept_value *v, const char *json, const char *end, const lept_parse_options *opt) {
+	lept_context c;
+	int ret;
+	assert(v != NULL);
+	c.json = json;
+	c.end = end;
+	c.stack = NULL;
+	c.size = c.top = 0;
+	c.frames = NULL;
+	c.frames_size = 0;
+	c.max_depth = opt != NULL ? opt->max_depth : 0;
+	c.arena = opt != NULL ? opt->arena : NULL;
+	c.symtab = opt != NULL ? opt->symtab : NULL;
+	c.stats = opt != NULL ? opt->stats : NULL;
+	c.allocator = opt != NULL && opt->allocator != NULL ? opt->allocator : &lept_global_allocator;
+	c.flags = opt != NULL ? opt->flags : 0;
+	c.lazy = NULL;
+	c.lazy_depth = 0;
+	assert(!(c.flags & LEPT_PARSE_FLAG_INSITU) || *end == '\0');
+	ret = lept_parse_context(&c, v);
+	LEPT_FREE(c.allocator, c.stack);
+	LEPT_FREE(c.allocator, c.frames);
+	if (opt != NULL && opt->offset != NULL)
+		*opt->offset = (size_t)(c.json - json);
+	return ret;
 }
 
-static void lept_parse_whitespace(lept_context *c) {
-	const char *p = c->json;
-	while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
-		p++;
-	c->json = p;
+/* 只读映射整个文件后解析，不经过中间拷贝；字符串都会复制到树中，返回前解除映射 */
+int lept_parse_file(lept_value *v, const char *path) {
+	int ret;
+#ifdef _WIN32
+	HANDLE file, mapping;
+	LARGE_INTEGER size;
+	const char *json;
+	assert(v != NULL && path != NULL);
+	lept_init(v);
+	file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return LEPT_PARSE_IO_ERROR;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return LEPT_PARSE_IO_ERROR;
+	}
+	if (size.QuadPart == 0) {
+		CloseHandle(file);
+		return lept_parse_n(v, "", 0);
+	}
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	json = mapping != NULL ? (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	if (json == NULL) {
+		if (mapping != NULL)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		return LEPT_PARSE_IO_ERROR;
+	}
+	ret = lept_parse_n(v, json, (size_t)size.QuadPart);
+	UnmapViewOfFile(json);
+	CloseHandle(mapping);
+	CloseHandle(file);
+#else
+	struct stat st;
+	void *json;
+	int fd;
+	assert(v != NULL && path != NULL);
+	lept_init(v);
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return LEPT_PARSE_IO_ERROR;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return LEPT_PARSE_IO_ERROR;
+	}
+	/* 长度为 0 的映射不合法 */
+	if (st.st_size == 0) {
+		close(fd);
+		return lept_parse_n(v, "", 0);
+	}
+	json = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (json == MAP_FAILED)
+		return LEPT_PARSE_IO_ERROR;
+	posix_madvise(json, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+	ret = lept_parse_n(v, (const char *)json, (size_t)st.st_size);
+	munmap(json, (size_t)st.st_size);
+#endif
+	return ret;
 }
 
-double lept_get_number(const lept_value *v) {
-	assert(v != NULL && v->type == LEPT_NUMBER);
-	return v->u.n;
+/* 线程、互斥量和读写锁的最小封装，只提供库内部需要的部分 */
+#ifdef _WIN32
+typedef HANDLE lept_thread;
+typedef CRITICAL_SECTION lept_mutex;
+typedef SRWLOCK lept_rwlock;
+#define lept_mutex_init(m) InitializeCriticalSection(m)
+#define lept_mutex_destroy(m) DeleteCriticalSection(m)
+#define lept_mutex_lock(m) EnterCriticalSection(m)
+#define lept_mutex_unlock(m) LeaveCriticalSection(m)
+#define lept_rwlock_init(l) InitializeSRWLock(l)
+#define lept_rwlock_destroy(l) ((void)(l))
+#define lept_rwlock_rdlock(l) AcquireSRWLockShared(l)
+#define lept_rwlock_rdunlock(l) ReleaseSRWLockShared(l)
+#define lept_rwlock_wrlock(l) AcquireSRWLockExclusive(l)
+#define lept_rwlock_wrunlock(l) ReleaseSRWLockExclusive(l)
+#else
+typedef pthread_t lept_thread;
+typedef pthread_mutex_t lept_mutex;
+typedef pthread_rwlock_t lept_rwlock;
+#define lept_mutex_init(m) pthread_mutex_init(m, NULL)
+#define lept_mutex_destroy(m) pthread_mutex_destroy(m)
+#define lept_mutex_lock(m) pthread_mutex_lock(m)
+#define lept_mutex_unlock(m) pthread_mutex_unlock(m)
+#define lept_rwlock_init(l) pthread_rwlock_init(l, NULL)
+#define lept_rwlock_destroy(l) pthread_rwlock_destroy(l)
+#define lept_rwlock_rdlock(l) pthread_rwlock_rdlock(l)
+#define lept_rwlock_rdunlock(l) pthread_rwlock_unlock(l)
+#define lept_rwlock_wrlock(l) pthread_rwlock_wrlock(l)
+#define lept_rwlock_wrunlock(l) pthread_rwlock_unlock(l)
+#endif
+
+typedef void (*lept_thread_fn)(void *);
+
+typedef struct {
+	lept_thread_fn fn;
+	void *arg;
+}lept_thread_start;
+
+#ifdef _WIN32
+static DWORD WINAPI lept_thread_main(LPVOID arg) {
+	lept_thread_start *s = (lept_thread_start *)arg;
+	s->fn(s->arg);
+	return 0;
 }
+#else
+static void *lept_thread_main(void *arg) {
+	lept_thread_start *s = (lept_thread_start *)arg;
+	s->fn(s->arg);
+	return NULL;
+}
+#endif
 
-static int lept_parse_number(lept_context *c, lept_value *v) {
-	const char *p = c->json;
-	char *end;
-	if (*p == '-')
-		p++;
-	if (*p == '0')
-		p++;
-	else {
-		if (!ISDIGIT1_9(*p))
-			return LEPT_PARSE_INVALID_VALUE;
-		while (ISDIGIT0_9(*p))
-			p++;
-	}
-	if (*p == '.') {
-		p++;
-		if(!ISDIGIT0_9(*(p))) 
-			return LEPT_PARSE_INVALID_VALUE;
-		while (ISDIGIT0_9(*p))
-			p++;
-	}
-	if (*p == 'E' || *p == 'e') {
-		p++;
-		if (*p == '+' || *p == '-')
-			p++;
-		if (!ISDIGIT0_9(*(p)))
-			return LEPT_PARSE_INVALID_VALUE;
-		while (ISDIGIT0_9(*p))
-			p++;
-	}
-	errno = 0;
-	v->u.n = strtod(c->json, &end);
-	if (errno == ERANGE && (v->u.n == HUGE_VAL || v->u.n == -HUGE_VAL))
-		return LEPT_PARSE_NUMBER_TOO_BIG;
-	if (c->json == end)
-		return LEPT_PARSE_INVALID_VALUE;
-	c->json = p;
-	v->type = LEPT_NUMBER;
-	return LEPT_PARSE_OK;
+/* s 在线程结束前必须保持有效；失败返回非 0 */
+static int lept_thread_create(lept_thread *t, lept_thread_start *s) {
+#ifdef _WIN32
+	return (*t = CreateThread(NULL, 0, lept_thread_main, s, 0, NULL)) == NULL;
+#else
+	return pthread_create(t, NULL, lept_thread_main, s) != 0;
+#endif
 }
 
-static int lept_parse_literal(lept_context *c, lept_value *v, const char *json, const lept_type type) {
-	size_t i = 0;
-	while (*(json + i) == *(c->json + i) && *(json + i) != '\0')
-			i++;
-	if (*(json + i) != '\0')
-		return LEPT_PARSE_INVALID_VALUE;
-	else {
-		c->json += i;
-		v->type = type;
-	}
-	return LEPT_PARSE_OK;
+static void lept_thread_join(lept_thread t) {
+#ifdef _WIN32
+	WaitForSingleObject(t, INFINITE);
+	CloseHandle(t);
+#else
+	pthread_join(t, NULL);
+#endif
 }
 
-void lept_set_string(lept_value *v, const char *s, size_t len) {
-	assert(v != NULL && (s != NULL || len == 0));
-	lept_free(v);
-	v->u.s.s = (char *)malloc(len + 1);
-	memcpy(v->u.s.s, s, len);
-	v->u.s.s[len] = '\0';
-	v->u.s.len = len;
-	v->type = LEPT_STRING;
+static unsigned lept_cpu_count(void) {
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (unsigned)info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (unsigned)n : 1;
+#else
+	return 1;
+#endif
 }
 
-void lept_free(lept_value *v) {
-	assert(v != NULL);
-	size_t i;
-	switch (v->type) {
-		case LEPT_STRING:
-			free(v->u.s.s);
-			break;
-		case LEPT_ARRAY:
-			for (i = 0; i < v->u.arr.size; i++)
-				lept_free(&v->u.arr.e[i]);
-			free(v->u.arr.e);
-			break;
-		case LEPT_OBJECT:
-			for (i = 0; i < v->u.o.size; i++) {
-				free(v->u.o.m[i].k);
-				lept_free(&v->u.o.m[i].v);
-			}
-			free(v->u.o.m);
+/* 工作线程每次从共享游标领取这么多条记录，减少加锁次数 */
+#ifndef LEPT_NDJSON_BATCH
+#define LEPT_NDJSON_BATCH 64
+#endif
+
+typedef struct {
+	const char *json;
+	lept_ndjson_record *records;
+	size_t count, next;
+	lept_mutex lock;
+}lept_ndjson_job;
+
+/* 每个工作线程有自己的 lept_context，解析栈在所有记录之间复用 */
+static void lept_ndjson_worker(void *arg) {
+	lept_ndjson_job *job = (lept_ndjson_job *)arg;
+	lept_context c;
+	size_t i, end;
+	c.stack = NULL;
+	c.size = c.top = 0;
+	c.frames = NULL;
+	c.frames_size = 0;
+	c.max_depth = 0;
+	c.arena = NULL;
+	c.symtab = NULL;
+	c.stats = NULL;
+	c.allocator = &lept_global_allocator;
+	c.flags = 0;
+	while (1) {
+		lept_mutex_lock(&job->lock);
+		i = job->next;
+		end = job->next = job->count - i > LEPT_NDJSON_BATCH ? i + LEPT_NDJSON_BATCH : job->count;
+		lept_mutex_unlock(&job->lock);
+		if (i == end)
 			break;
-		default: break;
+		for (; i < end; i++) {
+			lept_ndjson_record *r = &job->records[i];
+			c.json = job->json + r->offset;
+			c.end = c.json + r->length;
+			r->error = lept_parse_context(&c, &r->v);
+		}
 	}
-	v->type = LEPT_VOID;
+	LEPT_FREE(c.allocator, c.stack);
+	LEPT_FREE(c.allocator, c.frames);
 }
 
-void lept_set_boolean(lept_value *v, int num) {
-	assert(v != NULL);
-	lept_free(v);
-	v->type = num ? LEPT_TRUE : LEPT_FALSE;
+/* 按 '\n' 切分记录（JSON 字符串内不能出现未转义的换行，所以这总是记录边界），跳过只含空白的行，
+ * 再用 threads 个线程（0 表示 CPU 核数，调用线程也参与）并行解析。*records 按输入顺序排列，
+ * 每条记录有自己的值或错误码，用 lept_ndjson_free() 释放；返回记录数 */
+size_t lept_parse_ndjson(const char *json, size_t len, unsigned threads, lept_ndjson_record **records) {
+	lept_ndjson_job job;
+	lept_thread_start start;
+	lept_thread *pool;
+	const char *p = json, *end = json + len, *eol;
+	size_t size = 0, i;
+	unsigned n, started = 0;
+	assert(records != NULL && (json != NULL || len == 0));
+	lept_simd_init();
+	job.json = json;
+	job.records = NULL;
+	job.count = job.next = 0;
+	for (; p < end; p = eol + 1) {
+		if ((eol = (const char *)memchr(p, '\n', (size_t)(end - p))) == NULL)
+			eol = end;
+		if (lept_skip_whitespace(p, eol) == eol)
+			continue;
+		if (job.count == size) {
+			size = size == 0 ? 64 : size + (size >> 1);
+			job.records = (lept_ndjson_record *)LEPT_REALLOC(&lept_global_allocator, job.records, size * sizeof(lept_ndjson_record));
+			assert(job.records != NULL);
+		}
+		job.records[job.count].offset = (size_t)(p - json);
+		job.records[job.count++].length = (size_t)(eol - p);
+	}
+	*records = job.records;
+	if (job.count == 0)
+		return 0;
+	if (threads == 0)
+		threads = lept_cpu_count();
+	n = (size_t)threads > (job.count + LEPT_NDJSON_BATCH - 1) / LEPT_NDJSON_BATCH ? (unsigned)((job.count + LEPT_NDJSON_BATCH - 1) / LEPT_NDJSON_BATCH) : threads;
+	lept_mutex_init(&job.lock);
+	start.fn = lept_ndjson_worker;
+	start.arg = &job;
+	pool = n > 1 ? (lept_thread *)LEPT_MALLOC(&lept_global_allocator, (n - 1) * sizeof(lept_thread)) : NULL;
+	/* 创建线程失败时剩下的工作由已有的线程完成 */
+	if (pool != NULL)
+		while (started < n - 1 && lept_thread_create(&pool[started], &start) == 0)
+			started++;
+	lept_ndjson_worker(&job);
+	for (i = 0; i < started; i++)
+		lept_thread_join(pool[i]);
+	LEPT_FREE(&lept_global_allocator, pool);
+	lept_mutex_destroy(&job.lock);
+	return job.count;
 }
 
-int lept_get_boolean(const lept_value *v) {
-	assert(v != NULL && (v->type == LEPT_TRUE || v->type == LEPT_FALSE));
-	if (v->type == LEPT_TRUE)
-		return 1;
-	else return 0;
+void lept_ndjson_free(lept_ndjson_record *records, size_t count) {
+	size_t i;
+	for (i = 0; i < count; i++)
+		lept_free(&records[i].v);
+	LEPT_FREE(&lept_global_allocator, records);
 }
 
-void lept_set_double(lept_value *v, double num) {
-	assert(v != NULL );
-	lept_free(v);
-	v->type = LEPT_NUMBER;
-	v->u.n = num;
-}
+/* 一个 64 字节块中各类字符的位图，第 i 位对应第 i 个字节 */
+typedef struct {
+	uint64_t backslash, quote, op;
+}lept_block_masks;
 
-double lept_get_double(const lept_value *v) {
-	assert(v != NULL && v->type == LEPT_NUMBER);
-	return v->u.n;
+#ifdef LEPT_SSE2
+/* '[' '{' 只差 0x20 这一位，']' '}' 同理，所以四个括号只需两次比较 */
+static void lept_block_masks_fill(const char *p, lept_block_masks *m) {
+	int i;
+	m->backslash = m->quote = m->op = 0;
+	for (i = 0; i < 64; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(p + i)), lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+		__m128i op = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+		m->backslash |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << i;
+		m->quote |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"'))) << i;
+		m->op |= (uint64_t)(unsigned)_mm_movemask_epi8(op) << i;
+	}
+}
+#else
+static void lept_block_masks_fill(const char *p, lept_block_masks *m) {
+	int i;
+	m->backslash = m->quote = m->op = 0;
+	for (i = 0; i < 64; i++) {
+		uint64_t bit = 1ULL << i;
+		switch (p[i]) {
+			case '\\': m->backslash |= bit; break;
+			case '\"': m->quote |= bit; break;
+			case '{': case '}': case '[': case ']': case ':': case ',': m->op |= bit; break;
+		}
+	}
 }
+#endif
 
-const char *lept_get_string(const lept_value *v) {
-	assert(v != NULL && v->type == LEPT_STRING);
-	return v->u.s.s;
+/* 被转义的字符：奇数长度的 '\\' 序列之后的那个字节。*prev_escaped 为上一块最后一个 '\\' 是否延续到本块 */
+static uint64_t lept_escaped_mask(uint64_t backslash, uint64_t *prev_escaped) {
+	const uint64_t even_bits = 0x5555555555555555ULL;
+	uint64_t follows_escape, odd_starts, sequences;
+	backslash &= ~*prev_escaped;
+	follows_escape = backslash << 1 | *prev_escaped;
+	/* 从奇数位开始的序列加上自身后进位到序列末尾的下一位，借此区分序列起点的奇偶 */
+	odd_starts = backslash & ~even_bits & ~follows_escape;
+	sequences = odd_starts + backslash;
+	*prev_escaped = sequences < odd_starts;
+	return (even_bits ^ (sequences << 1)) & follows_escape;
 }
 
-size_t lept_get_len(const lept_value *v) {
-	assert(v != NULL && v->type == LEPT_STRING);
-	return v->u.s.len;
+/* 第 i 位为 x 中第 0..i 位的异或，即该字节是否位于引号之内（含开引号） */
+static uint64_t lept_prefix_xor(uint64_t x) {
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
 }
 
-static void *lept_context_push(lept_context *c, size_t size) {
-	void *ret;
-	assert(size > 0);
-	if (c->top + size >= c->size) {
-		if (c->size == 0)
-			c->size = LEPT_PARSE_STACK_INIT_SIZE;
-		while (c->top + size >= c->size) {
-			c->size += c->size >> 1;  // 扩大1.5倍
-			//如果增长因子是2，则必然不能用到之前分配的地址空间（因为2^n>2^0+2^1+...+2^(n-1)）,在缓存上不友好，故建议增长因子最好少于2，例如1.5
+/* 建立结构索引：每次处理 64 字节，用位运算去掉转义的引号和字符串内的字符，不逐字节分支。
+ * 只找结构，不做校验；字符串没有闭合或分配失败时返回 0 */
+static int lept_index_structurals(lept_structural_index *idx, const char *json, size_t len) {
+	lept_block_masks m;
+	uint64_t prev_escaped = 0, prev_in_string = 0, quote, in_string, bits;
+	uint32_t *pos;
+	char buf[64];
+	size_t i;
+	idx->count = 0;
+	for (i = 0; i < len; i += 64) {
+		const char *p = json + i;
+		if (len - i < 64) {
+			memset(buf, ' ', sizeof(buf));
+			memcpy(buf, p, len - i);
+			p = buf;
 		}
-		c->stack = (char *)realloc(c->stack, c->size); 
-		// realloc(NULL, size) 的行为是等价于 malloc(size) ,所以我们不需要为第一次分配内存作特别处理。
+		lept_block_masks_fill(p, &m);
+		quote = m.quote & ~lept_escaped_mask(m.backslash, &prev_escaped);
+		in_string = lept_prefix_xor(quote) ^ prev_in_string;
+		prev_in_string = (uint64_t)0 - (in_string >> 63);
+		bits = (m.op & ~in_string) | (quote & in_string);
+		if (idx->size - idx->count < 64) {
+			idx->size += idx->size >> 1;
+			if (idx->size < idx->count + 64)
+				idx->size = idx->count + 64;
+			if ((pos = (uint32_t *)LEPT_REALLOC(&lept_global_allocator, idx->pos, idx->size * sizeof(uint32_t))) == NULL)
+				return 0;
+			idx->pos = pos;
+		}
+		for (; bits != 0; bits &= bits - 1)
+			idx->pos[idx->count++] = (uint32_t)(i + lept_ctz64(bits));
 	}
-	ret = (char *)c->stack + c->top;
-	c->top += size;
-	return ret;
+	return prev_in_string == 0;
 }
 
-static void *lept_context_pop(lept_context *c, size_t size) {
-	assert(c->top >= size);
-	return (char *)c->stack + (c->top -= size);
+/* 按索引切分根数组：'['、深度为 1 的 ','、与之匹配的 ']' 依次改写到 idx->pos 前部，
+ * 相邻两项之间就是一个元素的文本。返回项数，结构不是单个数组时返回 0 */
+static size_t lept_index_top_level(const char *json, lept_structural_index *idx) {
+	size_t i, n = 0, depth = 0;
+	for (i = 0; i < idx->count; i++) {
+		uint32_t pos = idx->pos[i];
+		switch (json[pos]) {
+			case '[':
+			case '{':
+				if (depth++ == 0) {
+					if (i != 0 || json[pos] != '[')
+						return 0;
+					idx->pos[n++] = pos;
+				}
+				break;
+			case ']':
+			case '}':
+				if (--depth == 0) {
+					if (json[pos] != ']' || i + 1 != idx->count)
+						return 0;
+					idx->pos[n++] = pos;
+					return n;
+				}
+				break;
+			case ',':
+				if (depth == 1)
+					idx->pos[n++] = pos;
+				break;
+		}
+	}
+	return 0;
 }
 
-static int lept_parse_string(lept_context *c, lept_value *v) {
+/* 每个线程至少分到这么多个元素，否则不值得创建线程 */
+#ifndef LEPT_PARALLEL_GRAIN
+#define LEPT_PARALLEL_GRAIN 256
+#endif
+
+typedef struct {
+	const char *json;
+	const uint32_t *bounds;
+	lept_value *e;
+	size_t begin, end;
+	int ret;
+	lept_thread_start start;
+	lept_thread thread;
+}lept_parallel_job;
+
+/* 元素 i 的文本是 (bounds[i], bounds[i + 1])，直接解析到最终的元素块 e[i] 中 */
+static void lept_parallel_worker(void *arg) {
+	lept_parallel_job *job = (lept_parallel_job *)arg;
+	lept_context c;
+	size_t i;
+	c.stack = NULL;
+	c.size = c.top = 0;
+	c.frames = NULL;
+	c.frames_size = 0;
+	c.max_depth = 0;
+	c.arena = NULL;
+	c.symtab = NULL;
+	c.stats = NULL;
+	c.allocator = &lept_global_allocator;
+	c.flags = 0;
+	job->ret = LEPT_PARSE_OK;
+	for (i = job->begin; i < job->end && job->ret == LEPT_PARSE_OK; i++) {
+		c.json = job->json + job->bounds[i] + 1;
+		c.end = job->json + job->bounds[i + 1];
+		job->ret = lept_parse_context(&c, &job->e[i]);
+	}
+	LEPT_FREE(c.allocator, c.stack);
+	LEPT_FREE(c.allocator, c.frames);
+}
+
+/* 并行切分根数组：先建立结构索引，只用它找出深度为 1 的逗号，再把各元素的文本区间分给 threads 个线程
+ * （0 表示 CPU 核数，调用线程也参与）解析，结果直接写入同一个元素块。各元素仍由 lept_parse_value() 构造，
+ * 不按索引构造：它本来就用同样的向量内核跳过空白、扫描字符串，按索引构造为了与 lept_parse_n() 的错误码一致
+ * 仍要检查结构字符之间的每个字节，只是多一份语法检查的副本。
+ * 其他根类型、超过 4 GB 的输入和所有出错的情况都交给 lept_parse_n()，因此返回值和得到的值总是与 lept_parse_n() 相同 */
+int lept_parse_parallel(lept_value *v, const char *json, size_t len, unsigned threads) {
+	lept_structural_index idx;
+	lept_parallel_job *jobs;
+	lept_value *e;
+	const char *p;
+	size_t n, i;
+	unsigned t, k;
+	int ret = LEPT_PARSE_OK;
+	assert(v != NULL && (json != NULL || len == 0));
+	lept_simd_init();
+	p = lept_skip_whitespace(json, json + len);
+	if (p == json + len || *p != '[' || len > UINT32_MAX)
+		return lept_parse_n(v, json, len);
+	idx.pos = NULL;
+	idx.size = 0;
+	if (!lept_index_structurals(&idx, json, len) || idx.count == 0 || idx.pos[0] != (uint32_t)(p - json) ||
+		(n = lept_index_top_level(json, &idx)) == 0 ||
+		lept_skip_whitespace(json + idx.pos[n - 1] + 1, json + len) != json + len) {
+		LEPT_FREE(&lept_global_allocator, idx.pos);
+		return lept_parse_n(v, json, len);
+	}
+	lept_init(v);
+	v->type = LEPT_ARRAY;
+	v->u.arr.size = 0;
+	v->u.arr.e = NULL;
+	/* "[ ]" 切分出一个只含空白的元素 */
+	if (--n == 1 && lept_skip_whitespace(json + idx.pos[0] + 1, json + idx.pos[1]) == json + idx.pos[1]) {
+		LEPT_FREE(&lept_global_allocator, idx.pos);
+		return LEPT_PARSE_OK;
+	}
+	if (threads == 0)
+		threads = lept_cpu_count();
+	t = (size_t)threads > (n + LEPT_PARALLEL_GRAIN - 1) / LEPT_PARALLEL_GRAIN ? (unsigned)((n + LEPT_PARALLEL_GRAIN - 1) / LEPT_PARALLEL_GRAIN) : threads;
+	e = (lept_value *)LEPT_MALLOC(&lept_global_allocator, n * sizeof(lept_value));
+	jobs = (lept_parallel_job *)LEPT_MALLOC(&lept_global_allocator, t * sizeof(lept_parallel_job));
+	if (e == NULL || jobs == NULL) {
+		LEPT_FREE(&lept_global_allocator, e);
+		LEPT_FREE(&lept_global_allocator, jobs);
+		LEPT_FREE(&lept_global_allocator, idx.pos);
+		return lept_parse_n(v, json, len);
+	}
+	for (i = 0; i < n; i++)
+		lept_init(&e[i]);
+	for (k = 0; k < t; k++) {
+		jobs[k].json = json;
+		jobs[k].bounds = idx.pos;
+		jobs[k].e = e;
+		jobs[k].begin = n * k / t;
+		jobs[k].end = n * (k + 1) / t;
+		jobs[k].start.fn = lept_parallel_worker;
+		jobs[k].start.arg = &jobs[k];
+	}
+	/* 创建线程失败的那部分由调用线程完成 */
+	for (k = 1; k < t; k++)
+		if (lept_thread_create(&jobs[k].thread, &jobs[k].start) != 0)
+			break;
+	lept_parallel_worker(&jobs[0]);
+	for (i = k; i < t; i++)
+		lept_parallel_worker(&jobs[i]);
+	while (k > 1)
+		lept_thread_join(jobs[--k].thread);
+	for (k = 0; k < t; k++)
+		if (jobs[k].ret != LEPT_PARSE_OK)
+			ret = jobs[k].ret;
+	LEPT_FREE(&lept_global_allocator, jobs);
+	LEPT_FREE(&lept_global_allocator, idx.pos);
+	if (ret != LEPT_PARSE_OK) {
+		for (i = 0; i < n; i++)
+			lept_free(&e[i]);
+		LEPT_FREE(&lept_global_allocator, e);
+		return lept_parse_n(v, json, len);
+	}
+	v->u.arr.size = n;
+	v->u.arr.e = e;
+	return LEPT_PARSE_OK;
+}
+
+/* 驻留的键：规范副本前面是这个头，散列值只计算一次 */
+typedef struct {
+	size_t len;
+	uint32_t hash;
+}lept_symbol;
+
+#define LEPT_SYMBOL_OF(k) ((const lept_symbol *)(const void *)((k) - LEPT_ARENA_ALIGN(sizeof(lept_symbol))))
+
+/* 开放寻址表，slots 存规范副本的指针；副本从 arena 分配，地址在表的整个生命周期内不变 */
+struct lept_symtab {
+	const char **slots;
+	size_t size, count;
+	lept_arena arena;
+	lept_rwlock lock;
+};
+
+lept_symtab *lept_symtab_create(void) {
+	lept_symtab *t = (lept_symtab *)LEPT_MALLOC(&lept_global_allocator, sizeof(lept_symtab));
+	assert(t != NULL);
+	t->size = 64;
+	t->count = 0;
+	t->slots = (const char **)LEPT_MALLOC(&lept_global_allocator, t->size * sizeof(const char *));
+	assert(t->slots != NULL);
+	memset((void *)t->slots, 0, t->size * sizeof(const char *));
+	lept_arena_init(&t->arena, 0);
+	lept_rwlock_init(&t->lock);
+	return t;
+}
+
+/* 用这个表解析出的树都要在此之前释放 */
+void lept_symtab_destroy(lept_symtab *t) {
+	if (t == NULL)
+		return;
+	lept_rwlock_destroy(&t->lock);
+	lept_arena_free(&t->arena);
+	LEPT_FREE(&lept_global_allocator, (void *)t->slots);
+	LEPT_FREE(&lept_global_allocator, t);
+}
+
+static const char *lept_symtab_lookup(const lept_symtab *t, const char *key, size_t len, uint32_t hash) {
+	size_t i, mask = t->size - 1;
+	for (i = hash & mask; t->slots[i] != NULL; i = (i + 1) & mask) {
+		const lept_symbol *sym = LEPT_SYMBOL_OF(t->slots[i]);
+		if (sym->hash == hash && sym->len == len && memcmp(t->slots[i], key, len) == 0)
+			return t->slots[i];
+	}
+	return NULL;
+}
+
+/* 调用者持有写锁，且 key 尚不在表中。分配失败时返回 NULL，表保持不变 */
+static const char *lept_symtab_insert(lept_symtab *t, const char *key, size_t len, uint32_t hash) {
+	size_t i, mask;
+	lept_symbol *sym;
+	char *s;
+	if ((sym = (lept_symbol *)lept_arena_alloc(&t->arena, LEPT_ARENA_ALIGN(sizeof(lept_symbol)) + len + 1)) == NULL)
+		return NULL;
+	if ((t->count + 1) * 2 > t->size) {
+		const char **old = t->slots, **slots;
+		size_t old_size = t->size;
+		/* 符号占的 arena 空间就此浪费掉，表仍然一致 */
+		if ((slots = (const char **)LEPT_MALLOC(&lept_global_allocator, old_size * 2 * sizeof(const char *))) == NULL)
+			return NULL;
+		t->slots = slots;
+		t->size *= 2;
+		memset((void *)t->slots, 0, t->size * sizeof(const char *));
+		mask = t->size - 1;
+		for (i = 0; i < old_size; i++)
+			if (old[i] != NULL) {
+				size_t j = LEPT_SYMBOL_OF(old[i])->hash & mask;
+				while (t->slots[j] != NULL)
+					j = (j + 1) & mask;
+				t->slots[j] = old[i];
+			}
+		LEPT_FREE(&lept_global_allocator, (void *)old);
+	}
+	sym->len = len;
+	sym->hash = hash;
+	s = (char *)sym + LEPT_ARENA_ALIGN(sizeof(lept_symbol));
+	memcpy(s, key, len);
+	s[len] = '\0';
+	mask = t->size - 1;
+	for (i = hash & mask; t->slots[i] != NULL; i = (i + 1) & mask)
+		;
+	t->slots[i] = s;
+	t->count++;
+	return s;
+}
+
+/* 返回 key 的规范副本（以 '\0' 结尾），不存在时插入，插入时分配失败返回 NULL。可以被多个线程同时调用：
+ * 已有的键只需读锁，新键才短暂持有写锁 */
+const char *lept_symtab_intern(lept_symtab *t, const char *key, size_t len) {
+	uint32_t hash;
+	const char *s;
+	assert(t != NULL && (key != NULL || len == 0));
+	hash = lept_hash_key(key, len);
+	lept_rwlock_rdlock(&t->lock);
+	s = lept_symtab_lookup(t, key, len, hash);
+	lept_rwlock_rdunlock(&t->lock);
+	if (s != NULL)
+		return s;
+	lept_rwlock_wrlock(&t->lock);
+	if ((s = lept_symtab_lookup(t, key, len, hash)) == NULL)
+		s = lept_symtab_insert(t, key, len, hash);
+	lept_rwlock_wrunlock(&t->lock);
+	return s;
+}
+
+/* 只查找不插入，不存在时返回 NULL：用它预先取得要查找的字段，不会因为查询不存在的键让表增长 */
+const char *lept_symtab_find(lept_symtab *t, const char *key, size_t len) {
+	const char *s;
+	assert(t != NULL && (key != NULL || len == 0));
+	lept_rwlock_rdlock(&t->lock);
+	s = lept_symtab_lookup(t, key, len, lept_hash_key(key, len));
+	lept_rwlock_rdunlock(&t->lock);
+	return s;
+}
+
+/* 同 lept_parse_sax_ex()，json 以 '\0' 结尾，不限制嵌套深度 */
+int lept_parse_sax(const char *json, const lept_sax_handler *h, void *ctx) {
+	assert(json != NULL);
+	return lept_parse_sax_n(json, strlen(json), h, ctx);
+}
+
+/* 同 lept_parse_sax_ex()，opt 为 NULL */
+int lept_parse_sax_n(const char *json, size_t len, const lept_sax_handler *h, void *ctx) {
+	return lept_parse_sax_ex(json, len, h, ctx, NULL);
+}
+
+/* 不建立 DOM，按文档顺序对 json[0, len) 触发 h 中的回调，与 lept_parse_n() 一样不要求结尾的 '\0'。
+ * 字符串和键以指针 + 长度的形式给出，指向 c->stack 中解码后的内容（不以 '\0' 结尾），
+ * 只在回调期间有效，需要保留时由回调自行复制。出错时已经触发的事件不会撤销。
+ * opt 可以为 NULL；只使用其中的 max_depth、allocator（临时栈）、offset 和 LEPT_PARSE_FLAG_VALIDATE_UTF8 */
+int lept_parse_sax_ex(const char *json, size_t len, const lept_sax_handler *h, void *ctx, const lept_parse_options *opt) {
+	lept_context c;
+	int ret;
+	assert((json != NULL || len == 0) && h != NULL);
+	assert(opt == NULL || (!(opt->flags & ~LEPT_PARSE_FLAG_VALIDATE_UTF8) && opt->arena == NULL && opt->symtab == NULL));
+	lept_simd_init();
+	c.json = json;
+	c.end = json + len;
+	c.stack = NULL;
+	c.size = c.top = 0;
+	c.frames = NULL;
+	c.frames_size = 0;
+	c.max_depth = opt != NULL ? opt->max_depth : 0;
+	c.arena = NULL;
+	c.symtab = NULL;
+	c.stats = NULL;
+	c.allocator = opt != NULL && opt->allocator != NULL ? opt->allocator : &lept_global_allocator;
+	c.flags = opt != NULL ? opt->flags : 0;
+	lept_parse_whitespace(&c);
+	if ((ret = lept_sax_value(&c, h, ctx)) == LEPT_PARSE_OK) {
+		lept_parse_whitespace(&c);
+		if (c.json != c.end)
+			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+	}
+	assert(c.top == 0);
+	LEPT_FREE(c.allocator, c.stack);
+	LEPT_FREE(c.allocator, c.frames);
+	if (opt != NULL && opt->offset != NULL)
+		*opt->offset = (size_t)(c.json - json);
+	return ret;
+}
+
+struct lept_query {
+	lept_query_segment *segs;	/* 与键的内容一起紧跟在结构之后 */
+	size_t count, wildcards;
+};
+
+/* path 是 JSON Pointer（RFC 6901）："" 表示整个文档，"/a/0" 表示成员 a 的第 0 个元素，键中的 ~ 和 / 写作 ~0 和 ~1。
+ * 另外整段为 "*" 时匹配任意成员或元素（因此无法查询名为 "*" 的键）。path 不合法时返回 NULL */
+lept_query *lept_query_compile(const char *path) {
+	size_t count = 0, n, i;
+	const char *p;
+	char *k;
+	lept_query *q;
+	assert(path != NULL);
+	if (*path != '\0' && *path != '/')
+		return NULL;
+	for (p = path; *p != '\0'; p++)
+		count += *p == '/';
+	n = (size_t)(p - path);
+	/* 每段的键连同结尾的 '\0' 不会比原文（含前面的 '/'）长 */
+	q = (lept_query *)LEPT_MALLOC(&lept_global_allocator, sizeof(lept_query) + count * sizeof(lept_query_segment) + n);
+	assert(q != NULL);
+	q->segs = (lept_query_segment *)(q + 1);
+	q->count = count;
+	q->wildcards = 0;
+	k = (char *)(q->segs + count);
+	for (p = path, i = 0; i < count; i++) {
+		lept_query_segment *seg = &q->segs[i];
+		seg->key = k;
+		for (p++; *p != '\0' && *p != '/'; p++) {
+			if (*p != '~')
+				*k++ = *p;
+			else if (p[1] == '0' || p[1] == '1')
+				*k++ = *++p == '0' ? '~' : '/';
+			else {
+				LEPT_FREE(&lept_global_allocator, q);
+				return NULL;
+			}
+		}
+		seg->len = (size_t)(k - seg->key);
+		*k++ = '\0';
+		seg->wildcard = seg->len == 1 && seg->key[0] == '*';
+		seg->index = lept_query_index(seg->key, seg->len);
+		q->wildcards += seg->wildcard;
+	}
+	return q;
+}
+
+void lept_query_free(lept_query *q) {
+	LEPT_FREE(&lept_global_allocator, q);
+}
+
+/* "0" 或不以 0 开头的十进制数 */
+static size_t lept_query_index(const char *key, size_t len) {
+	size_t index = 0, i;
+	if (len == 0 || len > 19 || (key[0] == '0' && len > 1))
+		return LEPT_KEY_NOT_EXIST;
+	for (i = 0; i < len; i++) {
+		if (!ISDIGIT0_9(key[i]))
+			return LEPT_KEY_NOT_EXIST;
+		index = index * 10 + (size_t)(key[i] - '0');
+	}
+	return index;
+}
+
+/* 直接在 json[0, len) 的原文上匹配 q，按出现的顺序对每个命中的值调用 fn。不构造 DOM：
+ * 路径之外的子树用只配对引号和括号的扫描跳过，只有路径上的键和命中的标量才会解码。
+ * 只检查实际走过的部分，路径之外的语法错误不会被发现；查询没有通配符时找到第一个结果就返回。
+ * 返回 LEPT_PARSE_OK、走过的部分中遇到的解析错误，或者 LEPT_PARSE_SAX_ABORTED */
+int lept_query_run(const lept_query *q, const char *json, size_t len, lept_query_fn fn, void *ctx) {
+	lept_context c;
+	lept_query_frame stack[LEPT_WALK_STACK_SIZE], *frames = stack, *f;
+	size_t depth = 0;
+	int ret, matched = 1;
+	assert(q != NULL && (json != NULL || len == 0) && fn != NULL);
+	lept_simd_init();
+	c.json = json;
+	c.end = json + len;
+	c.stack = NULL;
+	c.size = c.top = 0;
+	c.frames = NULL;
+	c.frames_size = 0;
+	c.max_depth = 0;
+	c.arena = NULL;
+	c.symtab = NULL;
+	c.stats = NULL;
+	c.allocator = &lept_global_allocator;
+	c.flags = 0;
+	if (q->count > LEPT_WALK_STACK_SIZE && (frames = (lept_query_frame *)LEPT_MALLOC(c.allocator, q->count * sizeof(lept_query_frame))) == NULL)
+		return LEPT_PARSE_OUT_OF_MEMORY;
+	lept_parse_whitespace(&c);
+	while (1) {
+		/* c.json 位于第 depth 层容器的一个子节点（depth 为 0 时是根），matched 表示它与前 depth 段都匹配 */
+		if (!matched)
+			ret = lept_query_skip(&c);
+		else if (depth == q->count) {
+			if ((ret = lept_query_emit(&c, fn, ctx)) == LEPT_PARSE_OK && q->wildcards == 0)
+				break;
+		}
+		else if (PEEK(&c) == '[' || PEEK(&c) == '{') {
+			f = &frames[depth++];
+			f->close = *c.json++ == '[' ? ']' : '}';
+			f->i = 0;
+			lept_parse_whitespace(&c);
+			if (PEEK(&c) != f->close) {
+				if ((ret = lept_query_child(&c, &q->segs[depth - 1], f, &matched)) != LEPT_PARSE_OK)
+					break;
+				continue;
+			}
+			c.json++;
+			depth--;
+			ret = LEPT_PARSE_OK;
+		}
+		else
+			ret = lept_query_skip(&c);
+		if (ret != LEPT_PARSE_OK)
+			break;
+		/* 子节点结束：逗号之后接着读下一个，或者闭合所在的容器 */
+		while (depth > 0) {
+			f = &frames[depth - 1];
+			lept_parse_whitespace(&c);
+			if (PEEK(&c) == ',') {
+				c.json++;
+				lept_parse_whitespace(&c);
+				f->i++;
+				ret = lept_query_child(&c, &q->segs[depth - 1], f, &matched);
+				break;
+			}
+			if (PEEK(&c) != f->close) {
+				ret = f->close == ']' ? LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+				break;
+			}
+			c.json++;
+			depth--;
+		}
+		if (ret != LEPT_PARSE_OK || depth == 0)
+			break;
+	}
+	if (frames != stack)
+		LEPT_FREE(c.allocator, frames);
+	LEPT_FREE(c.allocator, c.stack);
+	return ret;
+}
+
+/* c->json 位于容器 f 的一个子节点：对象先读完键和 ':'，然后判断这个子节点是否与 seg 匹配 */
+static int lept_query_child(lept_context *c, const lept_query_segment *seg, lept_query_frame *f, int *matched) {
+	char *s;
+	size_t len;
+	int ret;
+	if (f->close == ']') {
+		*matched = seg->wildcard || f->i == seg->index;
+		return LEPT_PARSE_OK;
+	}
+	if (PEEK(c) != '"')
+		return LEPT_PARSE_MISS_KEY;
+	if (seg->wildcard) {
+		*matched = 1;
+		ret = lept_skip_string(c, 0);
+	}
+	else if ((ret = lept_parse_string_raw(c, &s, &len)) == LEPT_PARSE_OK)
+		*matched = len == seg->len && memcmp(s, seg->key, len) == 0;
+	if (ret != LEPT_PARSE_OK)
+		return ret;
+	lept_parse_whitespace(c);
+	if (PEEK(c) != ':')
+		return LEPT_PARSE_MISS_COLON;
+	c->json++;
+	lept_parse_whitespace(c);
+	return LEPT_PARSE_OK;
+}
+
+/* 把 c->json 处命中的值交给 fn：标量解码到 v，字符串借用 c->stack */
+static int lept_query_emit(lept_context *c, lept_query_fn fn, void *ctx) {
+	const char *start = c->json;
+	size_t head = c->top, len;
+	lept_value v;
+	char *s;
+	int ret;
+	lept_init(&v);
+	switch (PEEK(c)) {
+		case 'n': ret = lept_parse_literal(c, &v, "null", LEPT_NULL); break;
+		case 't': ret = lept_parse_literal(c, &v, "true", LEPT_TRUE); break;
+		case 'f': ret = lept_parse_literal(c, &v, "false", LEPT_FALSE); break;
+		case '\0': ret = LEPT_PARSE_EXPECT_VALUE; break;
+		case '\"':
+			if ((ret = lept_parse_string_raw(c, &s, &len)) != LEPT_PARSE_OK)
+				break;
+			assert(len <= LEPT_SIZE_MAX);
+			/* 解码结果就在栈顶之上，重新占住它并补上结尾的 '\0' */
+			if ((s = (char *)lept_context_push(c, len + 1)) == NULL) {
+				ret = LEPT_PARSE_OUT_OF_MEMORY;
+				break;
+			}
+			s[len] = '\0';
+			v.u.s.s = s;
+			v.u.s.len = (lept_size)len;
+			v.type = LEPT_STRING;
+			v.flags = LEPT_VALUE_BORROWED;
+			break;
+		case '[':
+		case '{':
+			if ((ret = lept_skip_container(c, 0)) != LEPT_PARSE_OK)
+				return ret;
+			return fn(ctx, NULL, start, (size_t)(c->json - start)) ? LEPT_PARSE_OK : LEPT_PARSE_SAX_ABORTED;
+		default: ret = lept_parse_number(c, &v); break;
+	}
+	if (ret == LEPT_PARSE_OK && !fn(ctx, &v, start, (size_t)(c->json - start)))
+		ret = LEPT_PARSE_SAX_ABORTED;
+	c->top = head;
+	return ret;
+}
+
+/* 跳过路径之外的值，不解码也不校验 */
+static int lept_query_skip(lept_context *c) {
+	const char *p = c->json;
+	switch (PEEK(c)) {
+		case '\"': return lept_skip_string(c, 0);
+		case '[':
+		case '{': return lept_skip_container(c, 0);
+		case '\0': return LEPT_PARSE_EXPECT_VALUE;
+		default:
+			while (p != c->end && *p != ',' && *p != ']' && *p != '}' && !ISWHITESPACE(*p))
+				p++;
+			if (p == c->json)
+				return LEPT_PARSE_INVALID_VALUE;
+			c->json = p;
+			return LEPT_PARSE_OK;
+	}
+}
+
+/* c->stack 由调用者提供，可以在多次解析之间复用 */
+static int lept_parse_context(lept_context *c, lept_value *v) {
+	int ret = 0;
+	const char *json = c->json;
+	lept_simd_init();
+	LEPT_STATS_BEGIN(c);
+	lept_init(v);
+	lept_parse_whitespace(c);
+	if((ret = lept_parse_value(c, v)) == LEPT_PARSE_OK) {
+		lept_parse_whitespace(c);
+		if (c->json != c->end) {
+			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+			lept_free_ex(v, c->allocator);
+		}
+	}
+	LEPT_STATS_END(c, (size_t)(c->json - json));
+	(void)json;
+	assert(c->top == 0);
+	return ret;
+}
+
+/* 不递归：尚未闭合的数组 / 对象记在 c->frames 中，已经解析出的元素 / 成员照旧压在 c->stack 上，
+ * C 栈的用量与嵌套深度无关。嵌套超过 c->max_depth 层时返回 LEPT_PARSE_DEPTH_EXCEEDED */
+static int lept_parse_value(lept_context *c, lept_value *v) {
+	lept_parser_frame *f;
+	lept_value e;
+	lept_type type;
+	size_t depth = 0, i;
+	int ret;
+	while (1) {
+		lept_init(&e);
+		switch (PEEK(c)) {
+			case 'n': ret = lept_parse_literal(c, &e, "null", LEPT_NULL); break;
+			case 't': ret = lept_parse_literal(c, &e, "true", LEPT_TRUE); break;
+			case 'f': ret = lept_parse_literal(c, &e, "false", LEPT_FALSE); break;
+			case '\0': ret = LEPT_PARSE_EXPECT_VALUE; break;
+			case '\"':
+				if ((c->flags & LEPT_PARSE_FLAG_LAZY) && depth > 0)
+					ret = lept_parse_lazy_value(c, &e, depth);
+				else
+					LEPT_STATS_TIMED(c, string_ns, ret = lept_parse_string(c, &e));
+				break;
+			case '[':
+			case '{':
+				if ((c->flags & LEPT_PARSE_FLAG_LAZY) && depth > 0) {
+					ret = lept_parse_lazy_value(c, &e, depth);
+					break;
+				}
+				if (c->max_depth != 0 && depth == c->max_depth) {
+					ret = LEPT_PARSE_DEPTH_EXCEEDED;
+					break;
+				}
+				type = *c->json++ == '[' ? LEPT_ARRAY : LEPT_OBJECT;
+				lept_parse_whitespace(c);
+				if (PEEK(c) == (type == LEPT_ARRAY ? ']' : '}')) {
+					c->json++;
+					if (type == LEPT_ARRAY)
+						lept_context_pop_array(c, &e, 0);
+					else
+						lept_context_pop_object(c, &e, 0);
+					ret = LEPT_PARSE_OK;
+					break;
+				}
+				if ((f = lept_context_push_frame(c, depth)) == NULL) {
+					ret = LEPT_PARSE_OUT_OF_MEMORY;
+					goto error;
+				}
+				depth++;
+				LEPT_STATS_MAX(c, max_depth, depth);
+				f->type = type;
+				f->size = 0;
+				f->has_key = 0;
+				if (type == LEPT_OBJECT && (ret = lept_parse_key(c, f)) != LEPT_PARSE_OK)
+					goto error;
+				/* 接着读第一个元素 / 成员的值 */
+				continue;
+			default: LEPT_STATS_TIMED(c, number_ns, ret = lept_parse_number(c, &e)); break;
+		}
+		if (ret != LEPT_PARSE_OK)
+			goto error;
+		/* e 是一个完整的值：成为结果，或者加入所在的数组 / 对象；闭合后的容器又是一个完整的值 */
+		while (1) {
+			LEPT_STATS_ADD(c, values[e.type], 1);
+			if (depth == 0) {
+				*v = e;
+				return LEPT_PARSE_OK;
+			}
+			f = &c->frames[depth - 1];
+			if (f->type == LEPT_ARRAY) {
+				lept_value *p = (lept_value *)lept_context_push(c, sizeof(lept_value));
+				if (p == NULL) {
+					lept_free_ex(&e, c->allocator);
+					ret = LEPT_PARSE_OUT_OF_MEMORY;
+					goto error;
+				}
+				*p = e;
+			}
+			else {
+				lept_member *m = (lept_member *)lept_context_push(c, sizeof(lept_member));
+				if (m == NULL) {
+					lept_free_ex(&e, c->allocator);
+					ret = LEPT_PARSE_OUT_OF_MEMORY;
+					goto error;
+				}
+				*m = f->key;
+				m->v = e;
+				m->v.flags |= f->key.v.flags & LEPT_KEY_FLAGS;
+				f->has_key = 0;
+			}
+			f->size++;
+			lept_parse_whitespace(c);
+			if (PEEK(c) == ',') {
+				c->json++;
+				lept_parse_whitespace(c);
+				if (f->type == LEPT_OBJECT && (ret = lept_parse_key(c, f)) != LEPT_PARSE_OK)
+					goto error;
+				break;
+			}
+			if (PEEK(c) != (f->type == LEPT_ARRAY ? ']' : '}')) {
+				ret = f->type == LEPT_ARRAY ? LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+				goto error;
+			}
+			c->json++;
+			lept_init(&e);
+			if (!(f->type == LEPT_ARRAY ? lept_context_pop_array(c, &e, f->size) : lept_context_pop_object(c, &e, f->size))) {
+				ret = LEPT_PARSE_OUT_OF_MEMORY;
+				goto error;
+			}
+			depth--;
+		}
+	}
+error:
+	/* 释放各层已经压栈的元素 / 成员和读完的键 */
+	while (depth > 0) {
+		f = &c->frames[--depth];
+		for (i = 0; i < f->size; i++) {
+			if (f->type == LEPT_ARRAY)
+				lept_free_ex((lept_value *)lept_context_pop(c, sizeof(lept_value)), c->allocator);
+			else {
+				lept_member *m = (lept_member *)lept_context_pop(c, sizeof(lept_member));
+				lept_member_free_key(c->allocator, m);
+				lept_free_ex(&m->v, c->allocator);
+			}
+		}
+		if (f->has_key)
+			lept_member_free_key(c->allocator, &f->key);
+	}
+	return ret;
+}
+
+/* 惰性模式：c->json 位于第 depth 层容器中的字符串、数组或对象开头，只找出它的范围记在 v 中；
+ * u.s.s 暂时指向原文，所在的容器闭合时由 lept_lazy_attach() 换成 lept_lazy_span */
+static int lept_parse_lazy_value(lept_context *c, lept_value *v, size_t depth) {
+	const char *start = c->json;
+	int ret;
+	if (*start == '\"')
+		ret = lept_skip_string(c, (c->flags & LEPT_PARSE_FLAG_VALIDATE) != 0);
+	else if (c->flags & LEPT_PARSE_FLAG_VALIDATE)
+		ret = lept_skip_validate(c, depth);
+	else
+		ret = lept_skip_container(c, depth);
+	if (ret != LEPT_PARSE_OK)
+		return ret;
+	assert((size_t)(c->json - start) <= LEPT_SIZE_MAX);
+	v->type = *start == '\"' ? LEPT_STRING : *start == '[' ? LEPT_ARRAY : LEPT_OBJECT;
+	v->u.s.s = (char *)start;
+	v->u.s.len = (lept_size)(c->json - start);
+	v->flags |= LEPT_VALUE_BORROWED | LEPT_VALUE_LAZY;
+	return LEPT_PARSE_OK;
+}
+
+/* 跳过 c->json 处的字符串，不解码；validate 时与 lept_parse_string_raw() 做同样的检查 */
+static int lept_skip_string(lept_context *c, int validate) {
+	const char *p = c->json + 1, *end = c->end;
+	const char *(*scan)(const char *, const char *) = c->flags & LEPT_PARSE_FLAG_VALIDATE_UTF8 ? lept_scan_string_utf8 : lept_scan_string;
+	char buf[4];
+	size_t n;
+	int ret;
+	while (1) {
+		p = scan(p, end);
+		if (p == end) {
+			c->json = p;
+			return LEPT_PARSE_MISS_QUOTATION_MARK;
+		}
+		switch (*p) {
+			case '\"':
+				c->json = p + 1;
+				return LEPT_PARSE_OK;
+			case '\\':
+				if (!validate) {
+					if (++p == end) {
+						c->json = p;
+						return LEPT_PARSE_MISS_QUOTATION_MARK;
+					}
+					p++;
+				}
+				else {
+					const char *q = lept_parse_escape(p + 1, end, buf, &n, &ret);
+					if (q == NULL) {
+						c->json = p;
+						return ret;
+					}
+					p = q;
+				}
+				break;
+			default:
+				/* 不合法的 UTF-8 不受 validate 影响，扫描时已经发现，直接报告 */
+				if ((unsigned char)*p >= 0x80) {
+					c->json = p;
+					return LEPT_PARSE_INVALID_UTF8;
+				}
+				if (validate) {
+					c->json = p;
+					return LEPT_PARSE_INVALID_STRING_CHAR;
+				}
+				p++;
+		}
+	}
+}
+
+/* 不校验：只按括号配对找到 c->json 处数组 / 对象的结尾，[ 与 { 不加区分，字符串中的括号不算 */
+static int lept_skip_container(lept_context *c, size_t depth) {
+	const char *p = c->json, *end = c->end;
+	char open = *p;
+	size_t level = 0;
+	int ret;
+	while (p != end) {
+		switch (*p) {
+			case '\"':
+				c->json = p;
+				if ((ret = lept_skip_string(c, 0)) != LEPT_PARSE_OK)
+					return ret;
+				p = c->json;
+				continue;
+			case '[':
+			case '{':
+				if (++level + depth > c->max_depth && c->max_depth != 0)
+					return LEPT_PARSE_DEPTH_EXCEEDED;
+				break;
+			case ']':
+			case '}':
+				if (--level == 0) {
+					c->json = p + 1;
+					return LEPT_PARSE_OK;
+				}
+				break;
+			default: break;
+		}
+		p++;
+	}
+	return open == '[' ? LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+}
+
+/* 完整校验 c->json 处的值并跳过它，不构造任何值，也不解码字符串；错误码与 lept_parse_value() 相同，
+ * 出错时 c->json 停在出错的位置附近（数字和字面量为其开头）。
+ * 不递归：尚未闭合的各层在位图中各占一位（1 为对象），不超过 LEPT_VALIDATE_STACK_DEPTH 层时位图在 C 栈上，不分配内存 */
+static int lept_skip_validate(lept_context *c, size_t depth) {
+	uint64_t stack[LEPT_VALIDATE_STACK_DEPTH / 64], *objects = stack;
+	size_t capacity = LEPT_VALIDATE_STACK_DEPTH, level = 0;
+	lept_value tmp;
+	int ret, is_object;
+	while (1) {
+		switch (PEEK(c)) {
+			case 'n': ret = lept_parse_literal(c, &tmp, "null", LEPT_NULL); break;
+			case 't': ret = lept_parse_literal(c, &tmp, "true", LEPT_TRUE); break;
+			case 'f': ret = lept_parse_literal(c, &tmp, "false", LEPT_FALSE); break;
+			case '\0': ret = LEPT_PARSE_EXPECT_VALUE; break;
+			case '\"': ret = lept_skip_string(c, 1); break;
+			case '[':
+			case '{':
+				if (c->max_depth != 0 && depth + level == c->max_depth) {
+					ret = LEPT_PARSE_DEPTH_EXCEEDED;
+					break;
+				}
+				is_object = *c->json++ == '{';
+				lept_parse_whitespace(c);
+				if (PEEK(c) == (is_object ? '}' : ']')) {
+					c->json++;
+					ret = LEPT_PARSE_OK;
+					break;
+				}
+				if (level == capacity) {
+					capacity *= 2;
+					uint64_t *p = (uint64_t *)(objects == stack ? LEPT_MALLOC(c->allocator, capacity / 8) : LEPT_REALLOC(c->allocator, objects, capacity / 8));
+					if (p == NULL) {
+						ret = LEPT_PARSE_OUT_OF_MEMORY;
+						goto done;
+					}
+					if (objects == stack)
+						memcpy(p, stack, sizeof(stack));
+					objects = p;
+				}
+				if (is_object)
+					objects[level / 64] |= (uint64_t)1 << (level % 64);
+				else
+					objects[level / 64] &= ~((uint64_t)1 << (level % 64));
+				level++;
+				if (is_object && (ret = lept_skip_key(c)) != LEPT_PARSE_OK)
+					goto done;
+				continue;
+			default: ret = lept_parse_number(c, &tmp); break;
+		}
+		if (ret != LEPT_PARSE_OK)
+			goto done;
+		/* 一个完整的值之后：逗号，或者闭合所在的容器 */
+		while (1) {
+			if (level == 0)
+				goto done;
+			is_object = (objects[(level - 1) / 64] >> ((level - 1) % 64)) & 1;
+			lept_parse_whitespace(c);
+			if (PEEK(c) == ',') {
+				c->json++;
+				lept_parse_whitespace(c);
+				if (is_object && (ret = lept_skip_key(c)) != LEPT_PARSE_OK)
+					goto done;
+				break;
+			}
+			if (PEEK(c) != (is_object ? '}' : ']')) {
+				ret = is_object ? LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET : LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+				goto done;
+			}
+			c->json++;
+			level--;
+		}
+	}
+done:
+	if (objects != stack)
+		LEPT_FREE(c->allocator, objects);
+	return ret;
+}
+
+/* 同 lept_parse_key()，但不保存键 */
+static int lept_skip_key(lept_context *c) {
+	int ret;
+	if (PEEK(c) != '"')
+		return LEPT_PARSE_MISS_KEY;
+	if ((ret = lept_skip_string(c, 1)) != LEPT_PARSE_OK)
+		return ret;
+	lept_parse_whitespace(c);
+	if (PEEK(c) != ':')
+		return LEPT_PARSE_MISS_COLON;
+	c->json++;
+	lept_parse_whitespace(c);
+	return LEPT_PARSE_OK;
+}
+
+/* 解码惰性节点 v 这一层，嵌套的容器和字符串仍是惰性的。沿用根解析的选项，max_depth 按 v 所在的层数折算；
+ * 根解析时校验过的子树不再重复校验。出错时 v 不变，返回错误码 */
+static int lept_lazy_load(lept_value *v) {
+	const lept_lazy_span *span = (const lept_lazy_span *)(const void *)v->u.s.s;
+	const lept_lazy_options *opt = span->opt;
+	lept_context c;
+	lept_value e;
+	int ret;
+	c.json = span->json;
+	c.end = c.json + v->u.s.len;
+	c.stack = NULL;
+	c.size = c.top = 0;
+	c.frames = NULL;
+	c.frames_size = 0;
+	c.max_depth = opt->max_depth != 0 ? opt->max_depth - span->depth : 0;
+	c.arena = opt->arena;
+	c.symtab = opt->symtab;
+	c.stats = NULL;
+	c.allocator = opt->allocator;
+	c.flags = opt->flags & ~LEPT_PARSE_FLAG_VALIDATE;
+	c.lazy = opt;
+	c.lazy_depth = span->depth;
+	ret = lept_parse_context(&c, &e);
+	LEPT_FREE(c.allocator, c.stack);
+	LEPT_FREE(c.allocator, c.frames);
+	if (ret != LEPT_PARSE_OK)
+		return ret;
+	assert(e.type == v->type);
+	e.flags |= v->flags & LEPT_KEY_FLAGS;
+	*v = e;
+	return LEPT_PARSE_OK;
+}
+
+/* 惰性模式下栈顶 n 个子节点（每个 stride 字节，值在其中的偏移 offset 处）需要的块尾大小：
+ * 每个惰性子节点一个 lept_lazy_span，根解析时还有一份选项。栈上的元素不一定对齐，只按字节读取 flags */
+static size_t lept_lazy_tail_size(const lept_context *c, size_t n, size_t stride, size_t offset) {
+	const char *p = (const char *)c->stack + c->top - n * stride + offset + offsetof(lept_value, flags);
+	size_t count = 0;
+	if (!(c->flags & LEPT_PARSE_FLAG_LAZY))
+		return 0;
+	for (; n > 0; n--, p += stride)
+		if ((unsigned char)*p & LEPT_VALUE_LAZY)
+			count++;
+	if (count == 0)
+		return 0;
+	return count * sizeof(lept_lazy_span) + (c->lazy == NULL ? LEPT_ARENA_ALIGN(sizeof(lept_lazy_options)) : 0);
+}
+
+/* 刚闭合的容器 v 的惰性子节点在块尾 tail 处各得到一个 lept_lazy_span，u.s.s 改为指向它；
+ * 根解析时块尾开头先复制一份选项，块不会再移动，所以之后各层都可以指向这里 */
+static void lept_lazy_attach(lept_context *c, lept_value *v, char *tail) {
+	const lept_lazy_options *opt = c->lazy;
+	lept_lazy_span *span;
+	size_t i;
+	if (opt == NULL) {
+		lept_lazy_options *o = (lept_lazy_options *)(void *)tail;
+		if (c->allocator == &lept_global_allocator)
+			o->allocator = &lept_global_allocator;
+		else {
+			o->custom = *c->allocator;
+			o->allocator = &o->custom;
+		}
+		o->arena = c->arena;
+		o->symtab = c->symtab;
+		o->max_depth = c->max_depth;
+		o->flags = c->flags;
+		opt = o;
+		tail += LEPT_ARENA_ALIGN(sizeof(lept_lazy_options));
+	}
+	span = (lept_lazy_span *)(void *)tail;
+	for (i = 0; i < LEPT_CHILD_COUNT(v); i++) {
+		lept_value *e = LEPT_CHILD(v, i);
+		if (e->flags & LEPT_VALUE_LAZY) {
+			span->json = e->u.s.s;
+			span->opt = opt;
+			span->depth = c->lazy_depth + 1;
+			e->u.s.s = (char *)span++;
+		}
+	}
+}
+
+static void lept_parse_whitespace(lept_context *c) {
+	const char *p = c->json, *end = c->end;
+	/* 紧凑的 JSON 里通常最多一个空白，只有更长的缩进才值得进入向量内核 */
+	if (p != end && ISWHITESPACE(*p)) {
+		p++;
+		if (p != end && ISWHITESPACE(*p))
+			p = lept_skip_whitespace(p + 1, end);
+	}
+	c->json = p;
+}
+
+static const char *lept_skip_whitespace_scalar(const char *p, const char *end) {
+	while (p != end && ISWHITESPACE(*p))
+		p++;
+	return p;
+}
+
+static const char *lept_scan_string_scalar(const char *p, const char *end) {
+	while (p != end && *p != '\"' && *p != '\\' && (unsigned char)*p >= 0x20)
+		p++;
+	return p;
+}
+
+/* p 处多字节 UTF-8 序列的长度；不合法（RFC 3629 的表 3-7）或在 end 之前被截断时返回 0 */
+static size_t lept_utf8_sequence(const char *p, const char *end) {
+	const unsigned char *s = (const unsigned char *)p;
+	unsigned char lo = 0x80, hi = 0xBF;
+	size_t n, i;
+	if (s[0] >= 0xC2 && s[0] <= 0xDF)
+		n = 2;
+	else if (s[0] >= 0xE0 && s[0] <= 0xEF) {
+		n = 3;
+		if (s[0] == 0xE0)
+			lo = 0xA0; /* 过长编码 */
+		else if (s[0] == 0xED)
+			hi = 0x9F; /* U+D800 ~ U+DFFF */
+	}
+	else if (s[0] >= 0xF0 && s[0] <= 0xF4) {
+		n = 4;
+		if (s[0] == 0xF0)
+			lo = 0x90;
+		else if (s[0] == 0xF4)
+			hi = 0x8F; /* 超过 U+10FFFF */
+	}
+	else
+		return 0;
+	if ((size_t)(end - p) < n || s[1] < lo || s[1] > hi)
+		return 0;
+	for (i = 2; i < n; i++)
+		if ((s[i] & 0xC0) != 0x80)
+			return 0;
+	return n;
+}
+
+static const char *lept_scan_string_utf8_scalar(const char *p, const char *end) {
+	size_t n;
+	while (p != end) {
+		unsigned char ch = (unsigned char)*p;
+		if (ch < 0x80) {
+			if (ch == '\"' || ch == '\\' || ch < 0x20)
+				return p;
+			p++;
+		}
+		else if ((n = lept_utf8_sequence(p, end)) != 0)
+			p += n;
+		else
+			return p;
+	}
+	return p;
+}
+
+#ifdef LEPT_SSE2
+static unsigned lept_whitespace_mask_sse2(__m128i v) {
+	__m128i ws = _mm_or_si128(
+		_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+		_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+	return ~(unsigned)_mm_movemask_epi8(ws) & 0xFFFF;
+}
+
+/* max(v, 0x1F) == 0x1F 即无符号 v <= 0x1F，SSE2 没有无符号比较 */
+static unsigned lept_special_mask_sse2(__m128i v) {
+	__m128i m = _mm_or_si128(
+		_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+		_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F)));
+	return (unsigned)_mm_movemask_epi8(m);
+}
+
+/* 非对齐加载，只读取 [p, end) 内的字节，不足一个向量的尾部交给标量实现 */
+static const char *lept_skip_whitespace_sse2(const char *p, const char *end) {
+	unsigned mask;
+	for (; end - p >= 16; p += 16)
+		if ((mask = lept_whitespace_mask_sse2(_mm_loadu_si128((const __m128i *)p))) != 0)
+			return p + lept_ctz(mask);
+	return lept_skip_whitespace_scalar(p, end);
+}
+
+static const char *lept_scan_string_sse2(const char *p, const char *end) {
+	unsigned mask;
+	for (; end - p >= 16; p += 16)
+		if ((mask = lept_special_mask_sse2(_mm_loadu_si128((const __m128i *)p))) != 0)
+			return p + lept_ctz(mask);
+	return lept_scan_string_scalar(p, end);
+}
+
+/* SSE2 没有 pshufb，做不了查表校验：纯 ASCII 的块一次跳过 16 字节，多字节序列逐个检查 */
+static const char *lept_scan_string_utf8_sse2(const char *p, const char *end) {
+	unsigned mask;
+	size_t n;
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+		if ((mask = lept_special_mask_sse2(v) | (unsigned)_mm_movemask_epi8(v)) == 0) {
+			p += 16;
+			continue;
+		}
+		p += lept_ctz(mask);
+		if ((unsigned char)*p < 0x80 || (n = lept_utf8_sequence(p, end)) == 0)
+			return p;
+		p += n;
+	}
+	return lept_scan_string_utf8_scalar(p, end);
+}
+#endif
+
+#ifdef LEPT_AVX2
+LEPT_TARGET_AVX2 static unsigned lept_whitespace_mask_avx2(__m256i v) {
+	__m256i ws = _mm256_or_si256(
+		_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+		_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+	return ~(unsigned)_mm256_movemask_epi8(ws);
+}
+
+LEPT_TARGET_AVX2 static unsigned lept_special_mask_avx2(__m256i v) {
+	__m256i m = _mm256_or_si256(
+		_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+		_mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8(0x1F)), _mm256_set1_epi8(0x1F)));
+	return (unsigned)_mm256_movemask_epi8(m);
+}
+
+LEPT_TARGET_AVX2 static const char *lept_skip_whitespace_avx2(const char *p, const char *end) {
+	unsigned mask;
+	for (; end - p >= 32; p += 32)
+		if ((mask = lept_whitespace_mask_avx2(_mm256_loadu_si256((const __m256i *)p))) != 0)
+			return p + lept_ctz(mask);
+	return lept_skip_whitespace_sse2(p, end);
+}
+
+LEPT_TARGET_AVX2 static const char *lept_scan_string_avx2(const char *p, const char *end) {
+	unsigned mask;
+	for (; end - p >= 32; p += 32)
+		if ((mask = lept_special_mask_avx2(_mm256_loadu_si256((const __m256i *)p))) != 0)
+			return p + lept_ctz(mask);
+	return lept_scan_string_sse2(p, end);
+}
+
+/* 查表校验 UTF-8 时的错误类别（Keiser & Lemire, 2021）：每一位代表一种非法的相邻两字节组合 */
+#define LEPT_UTF8_TOO_SHORT  0x01 /* 11______ 0_______ 或 11______ 11______ */
+#define LEPT_UTF8_TOO_LONG   0x02 /* 0_______ 10______ */
+#define LEPT_UTF8_OVERLONG_3 0x04 /* 11100000 100_____ */
+#define LEPT_UTF8_TOO_LARGE  0x08 /* 11110100 1001____ 及更大 */
+#define LEPT_UTF8_SURROGATE  0x10 /* 11101101 101_____ */
+#define LEPT_UTF8_OVERLONG_2 0x20 /* 1100000_ 10______ */
+#define LEPT_UTF8_TOO_LARGE_1000 0x40 /* 11110101 1000____ 及更大 */
+#define LEPT_UTF8_OVERLONG_4 0x40 /* 11110000 1000____ */
+#define LEPT_UTF8_TWO_CONTS  0x80 /* 10______ 10______ */
+#define LEPT_UTF8_CARRY (LEPT_UTF8_TOO_SHORT | LEPT_UTF8_TOO_LONG | LEPT_UTF8_TWO_CONTS)
+/* 表项可能 >= 0x80，先转成 char，免得 -pedantic 报 int 到 char 的溢出 */
+#define LEPT_UTF8_TABLE(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p) \
+	_mm256_setr_epi8((char)(a), (char)(b), (char)(c), (char)(d), (char)(e), (char)(f), (char)(g), (char)(h), \
+		(char)(i), (char)(j), (char)(k), (char)(l), (char)(m), (char)(n), (char)(o), (char)(p), \
+		(char)(a), (char)(b), (char)(c), (char)(d), (char)(e), (char)(f), (char)(g), (char)(h), \
+		(char)(i), (char)(j), (char)(k), (char)(l), (char)(m), (char)(n), (char)(o), (char)(p))
+
+/* 前一字节的高、低半字节和本字节的高半字节各查一张表，三者相与即相邻两字节的错误；
+ * 第 3、4 个字节只能由前 2、3 个字节的引导字节推出，与 TWO_CONTS 互相抵消。结果非 0 的字节不合法，
+ * 截断的序列在其后第一个非延续字节处报错。prev 为上一块，开头为 0（之前都是 ASCII） */
+LEPT_TARGET_AVX2 static __m256i lept_utf8_errors_avx2(__m256i v, __m256i prev) {
+	const __m256i low = _mm256_set1_epi8(0x0F);
+	__m256i joined = _mm256_permute2x128_si256(prev, v, 0x21);
+	__m256i prev1 = _mm256_alignr_epi8(v, joined, 15);
+	__m256i prev2 = _mm256_alignr_epi8(v, joined, 14);
+	__m256i prev3 = _mm256_alignr_epi8(v, joined, 13);
+	__m256i byte_1_high = _mm256_shuffle_epi8(LEPT_UTF8_TABLE(
+		LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG,
+		LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG, LEPT_UTF8_TOO_LONG,
+		LEPT_UTF8_TWO_CONTS, LEPT_UTF8_TWO_CONTS, LEPT_UTF8_TWO_CONTS, LEPT_UTF8_TWO_CONTS,
+		LEPT_UTF8_TOO_SHORT | LEPT_UTF8_OVERLONG_2,
+		LEPT_UTF8_TOO_SHORT,
+		LEPT_UTF8_TOO_SHORT | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_SURROGATE,
+		LEPT_UTF8_TOO_SHORT | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000 | LEPT_UTF8_OVERLONG_4),
+		_mm256_and_si256(_mm256_srli_epi16(prev1, 4), low));
+	__m256i byte_1_low = _mm256_shuffle_epi8(LEPT_UTF8_TABLE(
+		LEPT_UTF8_CARRY | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_OVERLONG_4,
+		LEPT_UTF8_CARRY | LEPT_UTF8_OVERLONG_2,
+		LEPT_UTF8_CARRY,
+		LEPT_UTF8_CARRY,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000 | LEPT_UTF8_SURROGATE,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000,
+		LEPT_UTF8_CARRY | LEPT_UTF8_TOO_LARGE | LEPT_UTF8_TOO_LARGE_1000),
+		_mm256_and_si256(prev1, low));
+	__m256i byte_2_high = _mm256_shuffle_epi8(LEPT_UTF8_TABLE(
+		LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT,
+		LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT,
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_TOO_LARGE_1000 | LEPT_UTF8_OVERLONG_4,
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_OVERLONG_3 | LEPT_UTF8_TOO_LARGE,
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_SURROGATE | LEPT_UTF8_TOO_LARGE,
+		LEPT_UTF8_TOO_LONG | LEPT_UTF8_OVERLONG_2 | LEPT_UTF8_TWO_CONTS | LEPT_UTF8_SURROGATE | LEPT_UTF8_TOO_LARGE,
+		LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT, LEPT_UTF8_TOO_SHORT),
+		_mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+	/* 无符号饱和减法后 >= 0x80 即 prev2 >= 0xE0 / prev3 >= 0xF0 */
+	__m256i must23 = _mm256_or_si256(
+		_mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+		_mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80))));
+	return _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8((char)0x80)),
+		_mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high));
+}
+
+/* 每次校验 32 字节，不区分 ASCII 与多字节；块内有错误或到了尾部才交给标量实现定位 */
+LEPT_TARGET_AVX2 static const char *lept_scan_string_utf8_avx2(const char *p, const char *end) {
+	const char *start = p, *q;
+	__m256i prev = _mm256_setzero_si256();
+	unsigned special, bad;
+	for (; end - p >= 32; p += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)p);
+		special = lept_special_mask_avx2(v);
+		bad = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lept_utf8_errors_avx2(v, prev), _mm256_setzero_si256()));
+		if (special != 0) {
+			/* 只看第一个特殊字符及之前的错误，停在它前面的截断序列正好在它那里报错 */
+			special &= 0u - special;
+			if ((bad & (special | (special - 1))) == 0)
+				return p + lept_ctz(special);
+			break;
+		}
+		if (bad != 0)
+			break;
+		prev = v;
+	}
+	/* p 之前都已校验过，只需退回到跨越 p 的那个序列的引导字节 */
+	q = p - start > 3 ? p - 3 : start;
+	while (q != p && ((unsigned char)*q & 0xC0) == 0x80)
+		q++;
+	return lept_scan_string_utf8_scalar(q, end);
+}
+
+static int lept_cpu_has_avx2(void) {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return 0;
+	__cpuid(info, 1);
+	/* OSXSAVE + AVX，并确认操作系统保存了 YMM 寄存器 */
+	if ((info[2] & (1 << 27 | 1 << 28)) != (1 << 27 | 1 << 28) || (_xgetbv(0) & 6) != 6)
+		return 0;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+static void lept_simd_select(void) {
+	lept_skip_whitespace = lept_skip_whitespace_scalar;
+	lept_scan_string = lept_scan_string_scalar;
+	lept_scan_string_utf8 = lept_scan_string_utf8_scalar;
+#ifdef LEPT_SSE2
+	lept_skip_whitespace = lept_skip_whitespace_sse2;
+	lept_scan_string = lept_scan_string_sse2;
+	lept_scan_string_utf8 = lept_scan_string_utf8_sse2;
+#endif
+#ifdef LEPT_AVX2
+	if (lept_cpu_has_avx2()) {
+		lept_skip_whitespace = lept_skip_whitespace_avx2;
+		lept_scan_string = lept_scan_string_avx2;
+		lept_scan_string_utf8 = lept_scan_string_utf8_avx2;
+	}
+#endif
+}
+
+/* 只执行一次 lept_simd_select()：多个线程同时第一次解析时也只写一遍函数指针，之后只读 */
+#ifdef _WIN32
+static INIT_ONCE lept_simd_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK lept_simd_select_once(PINIT_ONCE once, PVOID param, PVOID *ctx) {
+	(void)once;
+	(void)param;
+	(void)ctx;
+	lept_simd_select();
+	return TRUE;
+}
+#else
+static pthread_once_t lept_simd_once = PTHREAD_ONCE_INIT;
+#endif
+
+/* 每个公开入口在读扫描内核的函数指针之前调用，之后的读都排在唯一的那次写之后；已经选定时只是一次检查 */
+static void lept_simd_init(void) {
+#ifdef _WIN32
+	InitOnceExecuteOnce(&lept_simd_once, lept_simd_select_once, NULL, NULL);
+#else
+	pthread_once(&lept_simd_once, lept_simd_select);
+#endif
+}
+
+double lept_get_number(const lept_value *v) {
+	assert(v != NULL && v->type == LEPT_NUMBER);
+	return v->u.n;
+}
+
+/* 校验语法的同时把前 19 位有效数字累积进 w，值为 w * 10^exp10；
+ * 短整数直接转换，w 与 10^exp10 都能精确表示时一次乘除即正确舍入（Clinger），
+ * 其余走 Eisel-Lemire，只有截断了非零数字且无法判定时才回到大整数比较 */
+static int lept_parse_number(lept_context *c, lept_value *v) {
+	const char *p = c->json, *end = c->end;
+	uint64_t w = 0, bits;
+	int neg = 0, ndigits = 0, truncated = 0;
+	long exp10 = 0, e = 0;
+	double d;
+	if (p != end && *p == '-') {
+		neg = 1;
+		p++;
+	}
+	if (p != end && *p == '0')
+		p++;
+	else {
+		if (p == end || !ISDIGIT1_9(*p))
+			return LEPT_PARSE_INVALID_VALUE;
+		for (; p != end && ISDIGIT0_9(*p); p++) {
+			if (ndigits < 19) {
+				w = w * 10 + (unsigned)(*p - '0');
+				ndigits++;
+			}
+			else {
+				exp10++;
+				truncated |= *p != '0';
+			}
+		}
+	}
+	if (p != end && *p == '.') {
+		p++;
+		if (p == end || !ISDIGIT0_9(*p))
+			return LEPT_PARSE_INVALID_VALUE;
+		for (; p != end && ISDIGIT0_9(*p); p++) {
+			if (ndigits < 19) {
+				w = w * 10 + (unsigned)(*p - '0');
+				exp10--;
+				if (w != 0)
+					ndigits++;
+			}
+			else
+				truncated |= *p != '0';
+		}
+	}
+	if (p != end && (*p == 'E' || *p == 'e')) {
+		int eneg = 0;
+		p++;
+		if (p != end && (*p == '+' || *p == '-'))
+			eneg = *p++ == '-';
+		if (p == end || !ISDIGIT0_9(*p))
+			return LEPT_PARSE_INVALID_VALUE;
+		for (; p != end && ISDIGIT0_9(*p); p++)
+			if (e < 100000)
+				e = e * 10 + (*p - '0');
+		exp10 += eneg ? -e : e;
+	}
+	if (w == 0)
+		d = 0.0;
+	else if (!truncated && exp10 == 0 && w <= LEPT_DOUBLE_EXACT_INT)
+		d = (double)w;
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+	else if (!truncated && w <= LEPT_DOUBLE_EXACT_INT && exp10 >= -22 && exp10 <= 22)
+		d = exp10 < 0 ? (double)w / lept_exact_pow10[-exp10] : (double)w * lept_exact_pow10[exp10];
+#endif
+	else {
+		bits = lept_eisel_lemire(w, exp10);
+		/* 真值落在 w 与 w + 1 之间，两端舍入到同一个 double 时结果就确定了 */
+		if (truncated && lept_eisel_lemire(w + 1, exp10) != bits)
+			bits = lept_decimal_to_double_slow(c->json, p, bits);
+		if (bits == LEPT_DOUBLE_INF_BITS)
+			return LEPT_PARSE_NUMBER_TOO_BIG;
+		memcpy(&d, &bits, sizeof(d));
+	}
+	c->json = p;
+	v->u.n = neg ? -d : d;
+	v->type = LEPT_NUMBER;
+	return LEPT_PARSE_OK;
+}
+
+#if defined(__SIZEOF_INT128__)
+/* __extension__：__int128 不是 ISO C，免得 -pedantic 报警 */
+__extension__ typedef unsigned __int128 lept_uint128;
+
+static uint64_t lept_umul128(uint64_t a, uint64_t b, uint64_t *hi) {
+	lept_uint128 r = (lept_uint128)a * b;
+	*hi = (uint64_t)(r >> 64);
+	return (uint64_t)r;
+}
+#elif defined(_MSC_VER) && defined(_M_X64)
+static uint64_t lept_umul128(uint64_t a, uint64_t b, uint64_t *hi) {
+	return _umul128(a, b, hi);
+}
+#else
+static uint64_t lept_umul128(uint64_t a, uint64_t b, uint64_t *hi) {
+	uint64_t a0 = (uint32_t)a, a1 = a >> 32, b0 = (uint32_t)b, b1 = b >> 32;
+	uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+	uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+	*hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+	return (mid << 32) | (uint32_t)p00;
+}
+#endif
+
+static int lept_clz64(uint64_t x) {
+	int n = 0;
+	assert(x != 0);
+	while (!(x & 0xFFFFFFFF00000000ULL)) { n += 32; x <<= 32; }
+	while (!(x & 0x8000000000000000ULL)) { n++; x <<= 1; }
+	return n;
+}
+
+/* Eisel-Lemire：w 乘上 128 位近似的 5^q，高位即为尾数；对不超过 19 位的精确 w，
+ * 这个近似总是足以决定正确舍入（Mushtak & Lemire, 2023）。返回 IEEE-754 位模式 */
+static uint64_t lept_eisel_lemire(uint64_t w, long q) {
+	const uint64_t *t;
+	uint64_t lo, hi, hi2, mantissa;
+	int lz, upperbit;
+	long power2;
+	if (w == 0 || q < LEPT_POW5_MIN)
+		return 0;
+	if (q > LEPT_DOUBLE_MAX_EXP10)
+		return LEPT_DOUBLE_INF_BITS;
+	lz = lept_clz64(w);
+	w <<= lz;
+	t = lept_pow5_128[q - LEPT_POW5_MIN];
+	lo = lept_umul128(w, t[0], &hi);
+	/* 高 64 位中决定舍入的低位全为 1 时，才需要用表的低 64 位修正进位 */
+	if ((hi & 0x1FF) == 0x1FF) {
+		lept_umul128(w, t[1], &hi2);
+		lo += hi2;
+		if (hi2 > lo)
+			hi++;
+	}
+	upperbit = (int)(hi >> 63);
+	mantissa = hi >> (upperbit + 9);
+	/* (152170 + 65536) / 2^16 ≈ log2(10) */
+	power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023;
+	if (power2 <= 0) {
+		if (-power2 + 1 >= 64)
+			return 0;
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		/* 进位后可能恰好变成最小的正规数，第 52 位同时就是指数位 */
+		return mantissa;
+	}
+	/* 恰好位于两个 double 正中间时按偶数舍入 */
+	if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << (upperbit + 9)) == hi)
+		mantissa &= ~1ULL;
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= (2ULL << 52)) {
+		mantissa = 1ULL << 52;
+		power2++;
+	}
+	if (power2 >= 0x7FF)
+		return LEPT_DOUBLE_INF_BITS;
+	return (uint64_t)power2 << 52 | (mantissa & ~(1ULL << 52));
+}
+
+typedef struct {
+	uint32_t d[LEPT_BIGNUM_LIMBS];
+	int n;
+}lept_bignum;
+
+static void lept_bignum_mul_add(lept_bignum *b, uint32_t mul, uint32_t add) {
+	uint64_t carry = add;
+	int i;
+	for (i = 0; i < b->n; i++) {
+		carry += (uint64_t)b->d[i] * mul;
+		b->d[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+	if (carry) {
+		assert(b->n < LEPT_BIGNUM_LIMBS);
+		b->d[b->n++] = (uint32_t)carry;
+	}
+}
+
+static void lept_bignum_mul_pow5(lept_bignum *b, long e) {
+	static const uint32_t pow5[] = { 1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625 };
+	for (; e >= 13; e -= 13)
+		lept_bignum_mul_add(b, 1220703125u, 0); /* 5^13 */
+	if (e > 0)
+		lept_bignum_mul_add(b, pow5[e], 0);
+}
+
+static void lept_bignum_shl(lept_bignum *b, long bits) {
+	int limbs = (int)(bits / 32), r = (int)(bits % 32), i;
+	if (b->n == 0)
+		return;
+	assert(b->n + limbs < LEPT_BIGNUM_LIMBS);
+	b->d[b->n + limbs] = 0;
+	for (i = b->n - 1; i >= 0; i--) {
+		if (r)
+			b->d[i + limbs + 1] |= b->d[i] >> (32 - r);
+		b->d[i + limbs] = b->d[i] << r;
+	}
+	for (i = 0; i < limbs; i++)
+		b->d[i] = 0;
+	b->n += limbs + 1;
+	while (b->n > 0 && b->d[b->n - 1] == 0)
+		b->n--;
+}
+
+static int lept_bignum_cmp(const lept_bignum *a, const lept_bignum *b) {
+	int i;
+	if (a->n != b->n)
+		return a->n < b->n ? -1 : 1;
+	for (i = a->n - 1; i >= 0; i--)
+		if (a->d[i] != b->d[i])
+			return a->d[i] < b->d[i] ? -1 : 1;
+	return 0;
+}
+
+/* 截断后的尾数无法判定舍入方向时，答案只可能是 bits 或下一个 double（[p, end) 是已经校验过的数字）：
+ * 把全部有效数字 D * 10^e 与两者的中点 (2m + 1) * 2^(k - 1) 用大整数精确比较 */
+static uint64_t lept_decimal_to_double_slow(const char *p, const char *end, uint64_t bits) {
+	lept_bignum x, h;
+	uint64_t m;
+	long e = 0, k, ev = 0;
+	int ndigits = 0, sticky = 0, frac = 0, exp2, cmp;
+	uint32_t chunk = 0, scale = 1;
+	x.n = h.n = 0;
+	if (*p == '-')
+		p++;
+	for (; p != end && (ISDIGIT0_9(*p) || (*p == '.' && !frac)); p++) {
+		if (*p == '.') {
+			frac = 1;
+			continue;
+		}
+		if (ndigits == 0 && *p == '0') {
+			e -= frac;
+			continue;
+		}
+		/* 区分相邻的 double 最多需要 768 位有效数字，之后只需记录是否还有非零位 */
+		if (ndigits < LEPT_DECIMAL_MAX_DIGITS) {
+			chunk = chunk * 10 + (uint32_t)(*p - '0');
+			scale *= 10;
+			if (scale == 1000000000u) {
+				lept_bignum_mul_add(&x, scale, chunk);
+				chunk = 0;
+				scale = 1;
+			}
+			ndigits++;
+			e -= frac;
+		}
+		else {
+			sticky |= *p != '0';
+			e += !frac;
+		}
+	}
+	if (scale != 1)
+		lept_bignum_mul_add(&x, scale, chunk);
+	if (p != end && (*p == 'e' || *p == 'E')) {
+		int eneg = 0;
+		p++;
+		if (*p == '+' || *p == '-')
+			eneg = *p++ == '-';
+		for (; p != end && ISDIGIT0_9(*p); p++)
+			if (ev < 100000)
+				ev = ev * 10 + (*p - '0');
+		e += eneg ? -ev : ev;
+	}
+	exp2 = (int)(bits >> 52);
+	m = bits & ((1ULL << 52) - 1);
+	if (exp2 != 0)
+		m |= 1ULL << 52;
+	k = (exp2 != 0 ? exp2 : 1) - 1075 - 1;
+	m = 2 * m + 1;
+	h.d[0] = (uint32_t)m;
+	h.d[1] = (uint32_t)(m >> 32);
+	h.n = h.d[1] != 0 ? 2 : 1;
+	/* 比较 D * 5^e * 2^e 与 (2m + 1) * 2^k，负的幂次移到另一边 */
+	if (e >= 0)
+		lept_bignum_mul_pow5(&x, e);
+	else
+		lept_bignum_mul_pow5(&h, -e);
+	if (e >= k)
+		lept_bignum_shl(&x, e - k);
+	else
+		lept_bignum_shl(&h, k - e);
+	cmp = lept_bignum_cmp(&x, &h);
+	if (cmp > 0 || (cmp == 0 && (sticky || (bits & 1))))
+		bits++;
+	return bits;
+}
+
+static int lept_parse_literal(lept_context *c, lept_value *v, const char *json, const lept_type type) {
+	size_t i = 0;
+	while (json[i] != '\0' && c->json + i != c->end && json[i] == c->json[i])
+			i++;
+	if (*(json + i) != '\0')
+		return LEPT_PARSE_INVALID_VALUE;
+	else {
+		c->json += i;
+		v->type = type;
+	}
+	return LEPT_PARSE_OK;
+}
+
+void lept_set_string(lept_value *v, const char *s, size_t len) {
+	assert(v != NULL && (s != NULL || len == 0) && len <= LEPT_SIZE_MAX);
+	lept_free(v);
+	v->type = LEPT_STRING;
+	if (len < LEPT_STRING_INLINE_SIZE) {
+		lept_inline_store((char *)&v->u, LEPT_STRING_INLINE_SIZE, s, len);
+		v->flags |= LEPT_STRING_INLINE;
+		return;
+	}
+	v->u.s.s = (char *)LEPT_MALLOC(&lept_global_allocator, len + 1);
+	assert(v->u.s.s != NULL);
+	memcpy(v->u.s.s, s, len);
+	v->u.s.s[len] = '\0';
+	v->u.s.len = len;
+}
+
+/* 把长度小于 size 的 s 连同结尾的 '\0' 存入 buf，最后一个字节记录 size - 1 - len */
+static void lept_inline_store(char *buf, size_t size, const char *s, size_t len) {
+	assert(len < size);
+	/* lept_set_string(v, NULL, 0) 也会走到这里，memcpy 的参数不能为 NULL */
+	if (len)
+		memcpy(buf, s, len);
+	memset(buf + len, 0, size - 1 - len);
+	buf[size - 1] = (char)(size - 1 - len);
+}
+
+static void lept_walk_init(lept_walk *w, const lept_allocator *a) {
+	w->allocator = a;
+	w->frames = w->stack;
+	w->depth = 0;
+	w->size = LEPT_WALK_STACK_SIZE;
+}
+
+/* 分配失败时返回 0，已有的各层保持不变 */
+static int lept_walk_push(lept_walk *w, const lept_value *v) {
+	if (w->depth == w->size) {
+		size_t n = w->size + (w->size >> 1);
+		lept_walk_frame *frames = (lept_walk_frame *)(w->frames == w->stack ? LEPT_MALLOC(w->allocator, n * sizeof(lept_walk_frame)) : LEPT_REALLOC(w->allocator, w->frames, n * sizeof(lept_walk_frame)));
+		if (frames == NULL)
+			return 0;
+		if (w->frames == w->stack)
+			memcpy(frames, w->stack, w->depth * sizeof(lept_walk_frame));
+		w->frames = frames;
+		w->size = n;
+	}
+	w->frames[w->depth].v = v;
+	w->frames[w->depth++].i = 0;
+	return 1;
+}
+
+static void lept_walk_free(lept_walk *w) {
+	if (w->frames != w->stack)
+		LEPT_FREE(w->allocator, w->frames);
+}
+
+/* 只释放 v 自身持有的内存（字符串、元素块或成员块），不处理子节点 */
+static void lept_free_payload(const lept_allocator *a, lept_value *v) {
+	if (v->flags & LEPT_VALUE_BORROWED)
+		return;
+	switch (v->type) {
+		case LEPT_STRING:
+			if (!(v->flags & LEPT_STRING_INLINE))
+				LEPT_FREE(a, v->u.s.s);
+			break;
+		case LEPT_ARRAY:
+			LEPT_FREE(a, v->u.arr.e);
+			break;
+		case LEPT_OBJECT:
+			if (v->flags & LEPT_OBJECT_HEADER) {
+				const lept_object_header *h = LEPT_OBJECT_HEADER_OF(v);
+				LEPT_FREE(a, h->slots);
+				LEPT_FREE(a, v->u.o.m - 1);
+			}
+			else
+				LEPT_FREE(a, v->u.o.m);
+			break;
+		default: break;
+	}
+}
+
+void lept_free(lept_value *v) {
+	lept_free_ex(v, NULL);
+}
+
+/* 不递归：先释放子节点（对象还有键），最后释放容器自身的内存块；借用的子树整个跳过。
+ * a 须是构造这棵树时用的分配器，NULL 表示全局分配器 */
+void lept_free_ex(lept_value *v, const lept_allocator *a) {
+	lept_walk w;
+	lept_value *cur = v, *parent = NULL;
+	int ok;
+	assert(v != NULL);
+	if (a == NULL)
+		a = &lept_global_allocator;
+	lept_walk_init(&w, a);
+	while (1) {
+		if (!(cur->flags & LEPT_VALUE_BORROWED) && LEPT_CHILD_COUNT(cur) != 0) {
+			/* 释放没有出错的途径：超过 LEPT_WALK_STACK_SIZE 层时遍历栈必须分配成功 */
+			ok = lept_walk_push(&w, cur);
+			assert(ok);
+			(void)ok;
+			cur = LEPT_CHILD(cur, 0);
+			continue;
+		}
+		lept_free_payload(a, cur);
+		/* cur 已经释放：转到所在容器的下一个子节点，子节点都释放后再释放容器 */
+		while (w.depth > 0) {
+			lept_walk_frame *f = &w.frames[w.depth - 1];
+			parent = (lept_value *)f->v;
+			if (parent->type == LEPT_OBJECT)
+				lept_member_free_key(a, &parent->u.o.m[f->i]);
+			if (++f->i < LEPT_CHILD_COUNT(parent))
+				break;
+			lept_free_payload(a, parent);
+			w.depth--;
+		}
+		if (w.depth == 0)
+			break;
+		cur = LEPT_CHILD(parent, w.frames[w.depth - 1].i);
+	}
+	lept_walk_free(&w);
+	v->type = LEPT_VOID;
+	v->flags &= LEPT_KEY_FLAGS;
+}
+
+static void lept_member_free_key(const lept_allocator *a, lept_member *m) {
+	if (!(m->v.flags & (LEPT_KEY_BORROWED | LEPT_KEY_INLINE)))
+		LEPT_FREE(a, m->k);
+}
+
+/* s 为解析出的键（原地模式下以 '\0' 结尾并可以直接引用）。m->v.flags 中的键标记须已清零 */
+/* 分配失败时返回 0 */
+static int lept_member_set_key(lept_context *c, lept_member *m, char *s, size_t len) {
+	assert(len <= LEPT_SIZE_MAX);
+	/* 驻留的键即使很短也不内联，这样相同的键总是同一个指针 */
+	if (c->symtab != NULL) {
+		if ((m->k = (char *)lept_symtab_intern(c->symtab, s, len)) == NULL)
+			return 0;
+		m->klen = (lept_size)len;
+		m->v.flags |= LEPT_KEY_BORROWED | LEPT_KEY_INTERNED;
+		return 1;
+	}
+	if (len < LEPT_KEY_INLINE_SIZE) {
+		lept_inline_store((char *)m, LEPT_KEY_INLINE_SIZE, s, len);
+		m->v.flags |= LEPT_KEY_INLINE;
+		return 1;
+	}
+	m->klen = (lept_size)len;
+	if (c->flags & LEPT_PARSE_FLAG_INSITU)
+		m->k = s;
+	else {
+		if ((m->k = (char *)lept_context_alloc(c, len + 1)) == NULL)
+			return 0;
+		memcpy(m->k, s, len);
+		m->k[len] = '\0';
+	}
+	if (c->arena != NULL || (c->flags & LEPT_PARSE_FLAG_INSITU))
+		m->v.flags |= LEPT_KEY_BORROWED;
+	return 1;
+}
+
+void lept_set_boolean(lept_value *v, int num) {
+	assert(v != NULL);
+	lept_free(v);
+	v->type = num ? LEPT_TRUE : LEPT_FALSE;
+}
+
+int lept_get_boolean(const lept_value *v) {
+	assert(v != NULL && (v->type == LEPT_TRUE || v->type == LEPT_FALSE));
+	if (v->type == LEPT_TRUE)
+		return 1;
+	else return 0;
+}
+
+void lept_set_double(lept_value *v, double num) {
+	assert(v != NULL );
+	lept_free(v);
+	v->type = LEPT_NUMBER;
+	v->u.n = num;
+}
+
+double lept_get_double(const lept_value *v) {
+	assert(v != NULL && v->type == LEPT_NUMBER);
+	return v->u.n;
+}
+
+const char *lept_get_string(const lept_value *v) {
+	assert(v != NULL && v->type == LEPT_STRING);
+	LEPT_LAZY_LOAD(v, NULL);
+	return LEPT_STRING_DATA(v);
+}
+
+size_t lept_get_len(const lept_value *v) {
+	assert(v != NULL && v->type == LEPT_STRING);
+	LEPT_LAZY_LOAD(v, 0);
+	return LEPT_STRING_LEN(v);
+}
+
+/* 分配失败时返回 NULL，原来的栈和其中的内容保持不变 */
+static void *lept_context_push(lept_context *c, size_t size) {
+	void *ret;
+	assert(size > 0);
+	if (c->top + size >= c->size) {
+		size_t n = c->size == 0 ? LEPT_PARSE_STACK_INIT_SIZE : c->size;
+		while (c->top + size >= n) {
+			n += n >> 1;  // 扩大1.5倍
+			//如果增长因子是2，则必然不能用到之前分配的地址空间（因为2^n>2^0+2^1+...+2^(n-1)）,在缓存上不友好，故建议增长因子最好少于2，例如1.5
+		}
+		ret = LEPT_REALLOC(c->allocator, c->stack, n); 
+		// realloc(NULL, size) 的行为是等价于 malloc(size) ,所以我们不需要为第一次分配内存作特别处理。
+		if (ret == NULL)
+			return NULL;
+		c->stack = ret;
+		c->size = n;
+		LEPT_STATS_ADD(c, reallocs, 1);
+		LEPT_STATS_ADD(c, stack_grows, 1);
+	}
+	ret = (char *)c->stack + c->top;
+	c->top += size;
+	LEPT_STATS_MAX(c, stack_peak, c->top);
+	return ret;
+}
+
+static int lept_context_putc(lept_context *c, char ch) {
+	char *p = (char *)lept_context_push(c, 1);
+	if (p == NULL)
+		return 0;
+	*p = ch;
+	return 1;
+}
+
+static int lept_context_puts(lept_context *c, const char *s, size_t len) {
+	char *p = (char *)lept_context_push(c, len);
+	if (p == NULL)
+		return 0;
+	memcpy(p, s, len);
+	return 1;
+}
+
+static void *lept_context_pop(lept_context *c, size_t size) {
+	assert(c->top >= size);
+	return (char *)c->stack + (c->top -= size);
+}
+
+static int lept_parse_string(lept_context *c, lept_value *v) {
 	int ret;
 	size_t len;
 	char *s;
-	if ((ret = lept_parse_string_raw(c, &s, &len)) == LEPT_PARSE_OK)
-		lept_set_string(v, s, len);
+	if ((ret = lept_parse_string_raw(c, &s, &len)) == LEPT_PARSE_OK && !lept_context_set_string(c, v, s, len))
+		ret = LEPT_PARSE_OUT_OF_MEMORY;
 	return ret;
 }
+
+/* 把解码出的字符串存入 v：短的内联，原地解析时借用输入，否则从 c 的 arena 或分配器复制一份。分配失败时返回 0，v 不变 */
+static int lept_context_set_string(lept_context *c, lept_value *v, char *s, size_t len) {
+	assert(len <= LEPT_SIZE_MAX);
+	if (len < LEPT_STRING_INLINE_SIZE)
+		lept_set_string(v, s, len);
+	else if (c->flags & LEPT_PARSE_FLAG_INSITU) {
+		v->u.s.s = s;
+		v->u.s.len = len;
+		v->type = LEPT_STRING;
+		v->flags |= LEPT_VALUE_BORROWED;
+	}
+	else {
+		char *p = (char *)lept_context_alloc(c, len + 1);
+		if (p == NULL)
+			return 0;
+		memcpy(p, s, len);
+		p[len] = '\0';
+		v->u.s.s = p;
+		v->u.s.len = len;
+		v->type = LEPT_STRING;
+		if (c->arena != NULL)
+			v->flags |= LEPT_VALUE_BORROWED;
+	}
+	return 1;
+}
 /* 解析 JSON 字符串，把结果写入 str 和 len */
 /* str 指向 c->stack 中的元素，需要在 c->stack  */
+/* 原地模式下不经过 c->stack：解码结果写回输入缓冲区（解码后不会比原文长），str 指向缓冲区并以 '\0' 结尾 */
 static int lept_parse_string_raw(lept_context *c, char **str, size_t *size) {
-	size_t head = c->top;
-	char *p;
-	unsigned u, u_low;
+	size_t head = c->top, n;
+	char *p, *out, *start;
+	int insitu = (c->flags & LEPT_PARSE_FLAG_INSITU) != 0, ret;
+	const char *(*scan)(const char *, const char *) = c->flags & LEPT_PARSE_FLAG_VALIDATE_UTF8 ? lept_scan_string_utf8 : lept_scan_string;
 	EXPECT(c, '\"');
-	p = c->json;
+	p = start = out = (char *)c->json;
 	while (1) {
-		char ch = *p++;
-		switch (ch) {
+		/* 普通字符成段整体复制，只有遇到引号、转义或控制字符（校验 UTF-8 时还有不合法的序列）才逐字节处理 */
+		const char *q = scan(p, c->end);
+		if (q != p) {
+			n = (size_t)(q - p);
+			if (!insitu) {
+				if (!PUTS(c, p, n))
+					STRING_ERROR(LEPT_PARSE_OUT_OF_MEMORY);
+			}
+			else {
+				if (out != p)
+					memmove(out, p, n);
+				out += n;
+			}
+			p = (char *)q;
+		}
+		if (p == c->end)
+			STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
+		switch (*p++) {
 		case '\"':
-			*size = c->top - head;
-			//lept_set_string(v, (const char *)lept_context_pop(c, len), len);
-			*str = (char *)lept_context_pop(c, *size);
+			if (insitu) {
+				*size = (size_t)(out - start);
+				*out = '\0';
+				*str = start;
+			}
+			else {
+				*size = c->top - head;
+				*str = (char *)lept_context_pop(c, *size);
+			}
 			c->json = p;
 			return LEPT_PARSE_OK;
-		case '\0':
-			STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
 		case '\\':
-			switch (*p++) {
-			case '\"': PUTC(c, '\"'); break;
-			case '\\': PUTC(c, '\\'); break;
-			case '/':  PUTC(c, '/'); break;
-			case 'b':  PUTC(c, '\b'); break;
-			case 'f':  PUTC(c, '\f'); break;
-			case 'n':  PUTC(c, '\n'); break;
-			case 'r':  PUTC(c, '\r'); break;
-			case 't':  PUTC(c, '\t'); break;
-			case 'u':
-				if (!(p = lept_parse_hex4(p, &u)))
-					STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
-				if (u >= 0xD800 && u <= 0xDBFF) {
-					if (*p++ != '\\')
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
-					if (*p++ != 'u')
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
-					if (!(p = lept_parse_hex4(p, &u_low)))
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
-					if (u_low < 0xDC00 || u_low > 0xDFFF)
-						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
-					u = 0x10000 + (u - 0xD800) * 0x400 + (u_low - 0xDC00);
-				}
-				lept_encode_utf8(c, u);
+			if (insitu) {
+				if (!(p = (char *)lept_parse_escape(p, c->end, out, &n, &ret)))
+					STRING_ERROR(ret);
+				out += n;
+			}
+			else {
+				char buf[4];
+				if (!(p = (char *)lept_parse_escape(p, c->end, buf, &n, &ret)))
+					STRING_ERROR(ret);
+				if (!PUTS(c, buf, n))
+					STRING_ERROR(LEPT_PARSE_OUT_OF_MEMORY);
+			}
+			break;
+		default:
+			if ((unsigned char)p[-1] >= 0x80) {
+				c->json = p - 1;
+				STRING_ERROR(LEPT_PARSE_INVALID_UTF8);
+			}
+			STRING_ERROR(LEPT_PARSE_INVALID_STRING_CHAR);
+		}
+	}
+}
+
+/* 解码反斜杠之后的一个转义序列（不超过 end），把 1~4 个字节写入 out（读完整个序列后才写，out 可以与输入重叠），
+ * 返回序列之后的位置；出错时返回 NULL 并把错误码写入 err */
+static const char *lept_parse_escape(const char *p, const char *end, char *out, size_t *n, int *err) {
+	unsigned u, u_low;
+	*n = 1;
+	switch (p != end ? *p++ : '\0') {
+	case '\"': *out = '\"'; break;
+	case '\\': *out = '\\'; break;
+	case '/':  *out = '/'; break;
+	case 'b':  *out = '\b'; break;
+	case 'f':  *out = '\f'; break;
+	case 'n':  *out = '\n'; break;
+	case 'r':  *out = '\r'; break;
+	case 't':  *out = '\t'; break;
+	case 'u':
+		if (!(p = lept_parse_hex4(p, end, &u))) {
+			*err = LEPT_PARSE_INVALID_UNICODE_HEX;
+			return NULL;
+		}
+		if (u >= 0xD800 && u <= 0xDBFF) {
+			if (end - p < 2 || *p++ != '\\' || *p++ != 'u') {
+				*err = LEPT_PARSE_INVALID_UNICODE_SURROGATE;
+				return NULL;
+			}
+			if (!(p = lept_parse_hex4(p, end, &u_low))) {
+				*err = LEPT_PARSE_INVALID_UNICODE_HEX;
+				return NULL;
+			}
+			if (u_low < 0xDC00 || u_low > 0xDFFF) {
+				*err = LEPT_PARSE_INVALID_UNICODE_SURROGATE;
+				return NULL;
+			}
+			u = 0x10000 + (u - 0xD800) * 0x400 + (u_low - 0xDC00);
+		}
+		*n = (size_t)(lept_encode_utf8(out, u) - out);
+		break;
+	default:
+		*err = LEPT_PARSE_INVALID_STRING_ESCAPE;
+		return NULL;
+	}
+	return p;
+}
+
+/* u 不超过 0x10FFFF（代理对合成后的最大值），返回写入后的位置 */
+static char *lept_encode_utf8(char *p, const unsigned u) {
+	if (u <= 0x007F) {
+		*p++ = (char)(u & 0x007F);
+	}
+	else  if (u >= 0x0080 && u <= 0x07FF) {
+		*p++ = (char)(0xC0 | ((u >> 6) & 0x001F));
+		*p++ = (char)(0x80 | (u & 0x003F));
+	}
+	else if (u >= 0x0800 && u <= 0xFFFF) {
+		*p++ = (char)(0xE0 | ((u >> 12) & 0x000F));
+		*p++ = (char)(0x80 | ((u >> 6) & 0x003F));
+		*p++ = (char)(0x80 | (u & 0x003F));
+	}
+	else {
+		assert(u >= 0x10000 && u <= 0x10FFFF);
+		*p++ = (char)(0xF0 | ((u >> 18) & 0xFF));
+		*p++ = (char)(0x80 | ((u >> 12) & 0x3F));
+		*p++ = (char)(0x80 | ((u >> 6) & 0x3F));
+		*p++ = (char)(0x80 | (u & 0x3F));
+	}
+	return p;
+}
+
+/* 把栈顶的 size 个元素移入新分配的元素块，成为数组 v。分配失败时返回 0，元素仍留在栈上，v 不变 */
+static int lept_context_pop_array(lept_context *c, lept_value *v, size_t size) {
+	size_t tail;
+	lept_value *e;
+	assert(size <= LEPT_SIZE_MAX);
+	if (size == 0) {
+		v->type = LEPT_ARRAY;
+		v->u.arr.size = 0;
+		v->u.arr.e = NULL;
+		return 1;
+	}
+	tail = lept_lazy_tail_size(c, size, sizeof(lept_value), 0);
+	if (tail != 0)
+		tail += LEPT_ARENA_ALIGN(size * sizeof(lept_value)) - size * sizeof(lept_value);
+	if ((e = (lept_value *)lept_context_alloc(c, size * sizeof(lept_value) + tail)) == NULL)
+		return 0;
+	v->type = LEPT_ARRAY;
+	v->u.arr.size = size;
+	size *= sizeof(lept_value);
+	memcpy(v->u.arr.e = e, lept_context_pop(c, size), size);
+	if (c->arena != NULL)
+		v->flags |= LEPT_VALUE_BORROWED;
+	if (tail != 0)
+		lept_lazy_attach(c, v, (char *)v->u.arr.e + LEPT_ARENA_ALIGN(size));
+	return 1;
+}
+
+/* 把栈顶的 size 个成员移入新分配的成员块，成为对象 v。分配失败时返回 0，成员仍留在栈上，v 不变 */
+static int lept_context_pop_object(lept_context *c, lept_value *v, size_t size) {
+	size_t tail, block;
+	lept_member *m;
+	assert(size <= LEPT_SIZE_MAX);
+	if (size == 0) {
+		v->type = LEPT_OBJECT;
+		v->u.o.size = 0;
+		v->u.o.m = NULL;
+		return 1;
+	}
+	block = (size + (size >= LEPT_OBJECT_INDEX_THRESHOLD && size < UINT32_MAX)) * sizeof(lept_member);
+	if ((tail = lept_lazy_tail_size(c, size, sizeof(lept_member), offsetof(lept_member, v))) != 0)
+		tail += LEPT_ARENA_ALIGN(block) - block;
+	if ((m = (lept_member *)lept_context_alloc(c, block + tail)) == NULL)
+		return 0;
+	v->type = LEPT_OBJECT;
+	v->u.o.size = size;
+	if (size >= LEPT_OBJECT_INDEX_THRESHOLD && size < UINT32_MAX) {
+		v->u.o.m = m + 1;
+		LEPT_OBJECT_HEADER_OF(v)->slots = NULL;
+		LEPT_OBJECT_HEADER_OF(v)->arena = c->arena;
+		LEPT_OBJECT_HEADER_OF(v)->lazy_index = c->arena != NULL || c->allocator == &lept_global_allocator;
+		v->flags |= LEPT_OBJECT_HEADER;
+	}
+	else
+		v->u.o.m = m;
+	memcpy(v->u.o.m, lept_context_pop(c, size * sizeof(lept_member)), size * sizeof(lept_member));
+	if (c->arena != NULL)
+		v->flags |= LEPT_VALUE_BORROWED;
+	if (tail != 0)
+		lept_lazy_attach(c, v, (char *)(v->flags & LEPT_OBJECT_HEADER ? v->u.o.m - 1 : v->u.o.m) + LEPT_ARENA_ALIGN(block));
+	/* 索引建不起来时查找退回线性扫描，不算解析失败 */
+	if ((c->flags & LEPT_PARSE_FLAG_INDEX_OBJECTS) && (v->flags & LEPT_OBJECT_HEADER))
+		lept_object_build_index(v, c->allocator);
+	return 1;
+}
+
+size_t lept_get_array_size(const lept_value *v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_LAZY_LOAD(v, 0);
+	return v->u.arr.size;
+}
+
+lept_value * lept_get_array_element(const lept_value *v, size_t n) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	LEPT_LAZY_LOAD(v, NULL);
+	assert(n <= v->u.arr.size);
+	return &v->u.arr.e[n];
+}
+
+static const char *lept_parse_hex4(const char *p, const char *end, unsigned *u) {
+	size_t i;
+	*u = 0x00;
+	for (i = 0; i < 4; i++) {
+		if (p + i == end || !(ISHEX(*(p + i)))) {
+			return NULL;
+		}
+		else {
+			*u = *u << 4;
+			//*u += (*(p + i) - '0' >= 10) ? (*(p + i) - 'A' + 10) : (*(p + i) - '0');
+			if (*(p + i) >= '0' && *(p + i) <= '9')  *u += *(p + i) - '0';
+			else if (*(p + i) >= 'A' && *(p + i) <= 'F')  *u += *(p + i) - ('A' - 10);
+			else if (*(p + i) >= 'a' && *(p + i) <= 'f')  *u += *(p + i) - ('a' - 10);
+/* 如果使用strtol
+static const char* lept_parse_hex4(const char* p, unsigned* u) {
+	char* end;
+	*u = (unsigned)strtol(p, &end, 16);
+	return end == p + 4 ? end : NULL;
+}
+但这个实现会错误地接受 "\u 123" 这种不合法的 JSON，
+因为 strtol() 会跳过开始的空白。要解决的话，还需要检测第一个字符是否 [0-9A-Fa-f]，或者 !isspace(*p)*/
+		}
+	}
+	return p += 4;
+}
+
+void lept_set_null(lept_value *v) {
+	assert(v != NULL);
+	lept_free(v);
+	v->type = LEPT_NULL;
+}
+
+/* 读对象中的一个键和其后的 ':'，存入 f->key */
+static int lept_parse_key(lept_context *c, lept_parser_frame *f) {
+	char *s;
+	size_t len;
+	int ret;
+	if (PEEK(c) != '"')
+		return LEPT_PARSE_MISS_KEY;
+	LEPT_STATS_TIMED(c, string_ns, ret = lept_parse_string_raw(c, &s, &len));
+	if (ret != LEPT_PARSE_OK)
+		return ret;
+	f->key.v.flags = 0;
+	if (!lept_member_set_key(c, &f->key, s, len))
+		return LEPT_PARSE_OUT_OF_MEMORY;
+	f->has_key = 1;
+	lept_parse_whitespace(c);
+	if (PEEK(c) != ':')
+		return LEPT_PARSE_MISS_COLON;
+	c->json++;
+	lept_parse_whitespace(c);
+	return LEPT_PARSE_OK;
+}
+
+/* 分配失败时返回 NULL，已有的各层保持不变 */
+static lept_parser_frame *lept_context_push_frame(lept_context *c, size_t depth) {
+	if (depth == c->frames_size) {
+		size_t n = c->frames_size == 0 ? 16 : c->frames_size + (c->frames_size >> 1);
+		lept_parser_frame *frames = (lept_parser_frame *)LEPT_REALLOC(c->allocator, c->frames, n * sizeof(lept_parser_frame));
+		if (frames == NULL)
+			return NULL;
+		c->frames = frames;
+		c->frames_size = n;
+		LEPT_STATS_ADD(c, reallocs, 1);
+	}
+	return &c->frames[depth];
+}
+
+/*
+我们把这个指针调用 lept_parse_value(c, e)，
+这里会出现问题，因为 lept_parse_value() 及之下的函数都需要调用 lept_context_push()，
+而 lept_context_push() 在发现栈满了的时候会用 realloc() 扩容。
+这时候，我们上层的 e 就会失效，变成一个悬挂指针（dangling pointer），
+而且 lept_parse_value(c, e) 会通过这个指针写入解析结果，造成非法访问。
+在使用 C++ 容器时，也会遇到类似的问题。从容器中取得的迭代器（iterator）后，
+如果改动容器内容，之前的迭代器会失效。这里的悬挂指针问题也是相同的。
+
+但这种 bug 有时可能在简单测试中不能自动发现，因为问题只有堆栈满了才会出现。
+从测试的角度看，我们需要一些压力测试（stress test），测试更大更复杂的数据。
+但从编程的角度看，我们要谨慎考虑变量的生命周期，尽量从编程阶段避免出现问题
+
+例如把 lept_context_push() 的 API 改为：
+static void lept_context_push(
+lept_context* c, const void* data, size_t size);
+
+这样就确把数据压入栈内，避免了返回指针的生命周期问题。但我们之后会发现，原来的 API 设计在一些情况会更方便一些，
+例如在把字符串值转化（stringify）为 JSON 时，我们可以预先在堆栈分配字符串所需的最大空间，而当时是未有数据填充进去的。
+无论如何，我们编程时都要考虑清楚变量的生命周期，特别是指针的生命周期。
+*/
+
+/* 与 lept_parse_value 的语法和错误码完全一致，
+ * 词法部分（字面量、数字、字符串）直接复用 */
+/* 不递归：与 lept_parse_value() 一样，尚未闭合的数组 / 对象记在 c->frames 中（只用 type 和 size），
+ * C 栈的用量与嵌套深度无关。嵌套超过 c->max_depth 层时返回 LEPT_PARSE_DEPTH_EXCEEDED */
+static int lept_sax_value(lept_context *c, const lept_sax_handler *h, void *ctx) {
+	lept_parser_frame *f;
+	lept_value v;
+	char *s;
+	size_t depth = 0, len;
+	int ret, ok;
+	while (1) {
+		switch (PEEK(c)) {
+			case 'n':
+				if ((ret = lept_parse_literal(c, &v, "null", LEPT_NULL)) != LEPT_PARSE_OK)
+					return ret;
+				ok = SAX_EVENT(h, null, (ctx));
+				break;
+			case 't':
+			case 'f':
+				if ((ret = PEEK(c) == 't' ? lept_parse_literal(c, &v, "true", LEPT_TRUE) : lept_parse_literal(c, &v, "false", LEPT_FALSE)) != LEPT_PARSE_OK)
+					return ret;
+				ok = SAX_EVENT(h, boolean, (ctx, v.type == LEPT_TRUE));
+				break;
+			case '\0': return LEPT_PARSE_EXPECT_VALUE;
+			case '\"':
+				if ((ret = lept_parse_string_raw(c, &s, &len)) != LEPT_PARSE_OK)
+					return ret;
+				ok = SAX_EVENT(h, string, (ctx, s, len));
 				break;
+			case '[':
+			case '{':
+				if (c->max_depth != 0 && depth == c->max_depth)
+					return LEPT_PARSE_DEPTH_EXCEEDED;
+				if ((f = lept_context_push_frame(c, depth++)) == NULL)
+					return LEPT_PARSE_OUT_OF_MEMORY;
+				f->type = *c->json++ == '[' ? LEPT_ARRAY : LEPT_OBJECT;
+				f->size = 0;
+				if (!(f->type == LEPT_ARRAY ? SAX_EVENT(h, start_array, (ctx)) : SAX_EVENT(h, start_object, (ctx))))
+					return LEPT_PARSE_SAX_ABORTED;
+				lept_parse_whitespace(c);
+				if (PEEK(c) == (f->type == LEPT_ARRAY ? ']' : '}')) {
+					/* 空的数组 / 对象本身就是一个完整的值 */
+					c->json++;
+					depth--;
+					ok = f->type == LEPT_ARRAY ? SAX_EVENT(h, end_array, (ctx, 0)) : SAX_EVENT(h, end_object, (ctx, 0));
+					break;
+				}
+				if (f->type == LEPT_OBJECT && (ret = lept_sax_key(c, h, ctx)) != LEPT_PARSE_OK)
+					return ret;
+				/* 接着读第一个元素 / 成员的值 */
+				continue;
 			default:
-				STRING_ERROR(LEPT_PARSE_INVALID_STRING_ESCAPE);
+				if ((ret = lept_parse_number(c, &v)) != LEPT_PARSE_OK)
+					return ret;
+				ok = SAX_EVENT(h, number, (ctx, v.u.n));
+				break;
+		}
+		if (!ok)
+			return LEPT_PARSE_SAX_ABORTED;
+		/* 一个完整的值之后：逗号，或者闭合所在的容器；闭合后的容器又是一个完整的值 */
+		while (1) {
+			if (depth == 0)
+				return LEPT_PARSE_OK;
+			f = &c->frames[depth - 1];
+			f->size++;
+			lept_parse_whitespace(c);
+			if (PEEK(c) == ',') {
+				c->json++;
+				lept_parse_whitespace(c);
+				if (f->type == LEPT_OBJECT && (ret = lept_sax_key(c, h, ctx)) != LEPT_PARSE_OK)
+					return ret;
+				break;
 			}
-			break;
+			if (PEEK(c) != (f->type == LEPT_ARRAY ? ']' : '}'))
+				return f->type == LEPT_ARRAY ? LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+			c->json++;
+			depth--;
+			if (!(f->type == LEPT_ARRAY ? SAX_EVENT(h, end_array, (ctx, f->size)) : SAX_EVENT(h, end_object, (ctx, f->size))))
+				return LEPT_PARSE_SAX_ABORTED;
+		}
+	}
+}
+
+/* 读对象中的键并触发 key 事件，之后跳过 ':' 和空白 */
+static int lept_sax_key(lept_context *c, const lept_sax_handler *h, void *ctx) {
+	char *s;
+	size_t len;
+	int ret;
+	if (PEEK(c) != '"')
+		return LEPT_PARSE_MISS_KEY;
+	if ((ret = lept_parse_string_raw(c, &s, &len)) != LEPT_PARSE_OK)
+		return ret;
+	if (!SAX_EVENT(h, key, (ctx, s, len)))
+		return LEPT_PARSE_SAX_ABORTED;
+	lept_parse_whitespace(c);
+	if (PEEK(c) != ':')
+		return LEPT_PARSE_MISS_COLON;
+	c->json++;
+	lept_parse_whitespace(c);
+	return LEPT_PARSE_OK;
+}
+
+/* lept_parser：同一套语法的显式状态机版本，递归下降中隐含在调用栈里的位置都保存在 frames 和 state 中，
+ * 因此可以在任意字节处（字符串、数字、转义、代理对中间）暂停，等下一块输入到来再继续 */
+enum {
+	LEPT_STATE_VALUE,		/* 期待一个值 */
+	LEPT_STATE_ARRAY_FIRST,	/* '[' 之后 */
+	LEPT_STATE_ARRAY_NEXT,	/* 数组元素之后，期待 ',' 或 ']' */
+	LEPT_STATE_OBJECT_FIRST,	/* '{' 之后 */
+	LEPT_STATE_OBJECT_KEY,	/* 对象中 ',' 之后 */
+	LEPT_STATE_COLON,		/* 键之后 */
+	LEPT_STATE_OBJECT_NEXT,	/* 成员之后，期待 ',' 或 '}' */
+	LEPT_STATE_STRING,		/* 字符串（值或键）内，已解码部分在 c.stack 上 */
+	LEPT_STATE_ESCAPE,		/* 反斜杠之后，转义序列收集在 esc 中 */
+	LEPT_STATE_LITERAL,		/* null / true / false 中间 */
+	LEPT_STATE_NUMBER,		/* 数字中间，已读的字符在 c.stack 上 */
+	LEPT_STATE_END,			/* 根值之后，只允许空白 */
+	LEPT_STATE_DONE			/* 遇到了 '\0'，与 lept_parse() 一样忽略之后的输入 */
+};
+
+/* 数字语法的各个位置，与 lept_parse_number 的校验顺序对应 */
+enum {
+	LEPT_NUM_MINUS,		/* '-' 之后 */
+	LEPT_NUM_ZERO,		/* 整数部分为 0 */
+	LEPT_NUM_INT,		/* 整数部分 */
+	LEPT_NUM_DOT,		/* '.' 之后 */
+	LEPT_NUM_FRAC,		/* 小数部分 */
+	LEPT_NUM_E,			/* 'e' 之后 */
+	LEPT_NUM_ESIGN,		/* 指数符号之后 */
+	LEPT_NUM_EXP,		/* 指数部分 */
+	LEPT_NUM_STOP		/* 当前字符不属于这个数字 */
+};
+
+
+struct lept_parser {
+	lept_context c;
+	lept_parser_frame *frames;
+	size_t depth, frames_size;
+	lept_value root;
+	int has_root;
+	int state, error;
+	int is_key;			/* LEPT_STATE_STRING / ESCAPE 中正在读的是键 */
+	int num_state;
+	size_t head;		/* 当前字符串或数字在 c.stack 中的起点 */
+	size_t retain;		/* 文档之间保留的缓冲区上限，见 lept_parser_set_retain() */
+	const char *literal;
+	lept_type literal_type;
+	size_t literal_i;
+	char esc[11];		/* 反斜杠之后最长是 "uD834\uDD1E" */
+	size_t nesc;
+};
+
+lept_parser *lept_parser_create(void) {
+	lept_parser *p = (lept_parser *)LEPT_MALLOC(&lept_global_allocator, sizeof(lept_parser));
+	assert(p != NULL);
+	p->c.stack = NULL;
+	p->c.size = p->c.top = 0;
+	p->c.frames = NULL;
+	p->c.frames_size = 0;
+	p->c.max_depth = 0;
+	p->c.arena = NULL;
+	p->c.symtab = NULL;
+	p->c.stats = NULL;
+	p->c.allocator = &lept_global_allocator;
+	p->c.flags = 0;
+	p->c.lazy = NULL;
+	p->c.lazy_depth = 0;
+	p->frames = NULL;
+	p->depth = p->frames_size = 0;
+	p->has_root = 0;
+	p->state = LEPT_STATE_VALUE;
+	p->error = LEPT_PARSE_OK;
+	p->retain = LEPT_RETAIN_SIZE;
+	return p;
+}
+
+void lept_parser_destroy(lept_parser *p) {
+	if (p == NULL)
+		return;
+	lept_parser_clear(p);
+	LEPT_FREE(p->c.allocator, p->c.stack);
+	LEPT_FREE(p->c.allocator, p->c.frames);
+	LEPT_FREE(p->c.allocator, p->frames);
+	LEPT_FREE(&lept_global_allocator, p);
+}
+
+/* 把 len 字节喂给解析器。返回 LEPT_PARSE_OK 表示到目前为止没有错误；
+ * 一旦出错，错误码会一直保持到 lept_parse_finish() */
+int lept_parse_feed(lept_parser *p, const char *json, size_t len) {
+	const char *end = json + len;
+	assert(p != NULL && (json != NULL || len == 0));
+	lept_simd_init();
+	while (json < end && p->error == LEPT_PARSE_OK && p->state != LEPT_STATE_DONE)
+		json = lept_parser_run(p, json, end);
+	return p->error;
+}
+
+/* 输入结束：结果（及错误码）与对全部输入调用 lept_parse() 相同。之后解析器可以解析下一个文档 */
+int lept_parse_finish(lept_parser *p, lept_value *v) {
+	static const char eof = '\0';
+	int ret;
+	assert(p != NULL && v != NULL);
+	lept_init(v);
+	if (p->state != LEPT_STATE_DONE)
+		lept_parse_feed(p, &eof, 1);
+	if ((ret = p->error) == LEPT_PARSE_OK) {
+		assert(p->state == LEPT_STATE_DONE && p->has_root && p->depth == 0);
+		*v = p->root;
+		p->has_root = 0;
+	}
+	lept_parser_clear(p);
+	lept_parser_release(p, p->retain);
+	return ret;
+}
+
+/* 一次解析完整的 json[0, len)，结果与 lept_parse_n()/lept_parse_ex() 相同，但复用解析器保留的栈，
+ * 稳态下不再为栈分配内存。进行中的增量解析会被丢弃。opt 可以为 NULL，不支持原地解析和单独的分配器 */
+int lept_parser_parse(lept_parser *p, lept_value *v, const char *json, size_t len, const lept_parse_options *opt) {
+	int ret;
+	assert(p != NULL && v != NULL && (json != NULL || len == 0));
+	assert(opt == NULL || (!(opt->flags & LEPT_PARSE_FLAG_INSITU) && opt->allocator == NULL));
+	lept_parser_clear(p);
+	p->c.json = json;
+	p->c.end = json + len;
+	if (opt != NULL) {
+		p->c.flags = opt->flags;
+		p->c.arena = opt->arena;
+		p->c.symtab = opt->symtab;
+		p->c.max_depth = opt->max_depth;
+		p->c.stats = opt->stats;
+	}
+	ret = lept_parse_context(&p->c, v);
+	if (opt != NULL && opt->offset != NULL)
+		*opt->offset = (size_t)(p->c.json - json);
+	p->c.flags = 0;
+	p->c.arena = NULL;
+	p->c.symtab = NULL;
+	p->c.max_depth = 0;
+	p->c.stats = NULL;
+	lept_parser_release(p, p->retain);
+	return ret;
+}
+
+/* 每个文档结束后，容量超过 bytes 的缓冲区都释放掉，偶尔一个大文档不会让解析器一直占着内存。
+ * 0 表示从不保留（每次都重新分配），(size_t)-1 表示全部保留 */
+void lept_parser_set_retain(lept_parser *p, size_t bytes) {
+	assert(p != NULL);
+	p->retain = bytes;
+}
+
+/* 立即释放保留的全部缓冲区；进行中的增量解析会被丢弃 */
+void lept_parser_trim(lept_parser *p) {
+	assert(p != NULL);
+	lept_parser_clear(p);
+	lept_parser_release(p, 0);
+}
+
+/* 解析器空闲时调用：释放容量超过 bytes 的缓冲区 */
+static void lept_parser_release(lept_parser *p, size_t bytes) {
+	if (p->c.size > bytes) {
+		LEPT_FREE(p->c.allocator, p->c.stack);
+		p->c.stack = NULL;
+		p->c.size = 0;
+	}
+	if (p->c.frames_size * sizeof(lept_parser_frame) > bytes) {
+		LEPT_FREE(p->c.allocator, p->c.frames);
+		p->c.frames = NULL;
+		p->c.frames_size = 0;
+	}
+	if (p->frames_size * sizeof(lept_parser_frame) > bytes) {
+		LEPT_FREE(p->c.allocator, p->frames);
+		p->frames = NULL;
+		p->frames_size = 0;
+	}
+}
+
+/* 释放尚未组装完的部分，回到初始状态（保留 c.stack 和 frames 的容量） */
+static void lept_parser_clear(lept_parser *p) {
+	size_t i;
+	if (p->state == LEPT_STATE_STRING || p->state == LEPT_STATE_ESCAPE || p->state == LEPT_STATE_NUMBER)
+		p->c.top = p->head;
+	while (p->depth > 0) {
+		lept_parser_frame *f = &p->frames[--p->depth];
+		for (i = 0; i < f->size; i++) {
+			if (f->type == LEPT_ARRAY)
+				lept_free_ex((lept_value *)lept_context_pop(&p->c, sizeof(lept_value)), p->c.allocator);
+			else {
+				lept_member *m = (lept_member *)lept_context_pop(&p->c, sizeof(lept_member));
+				lept_member_free_key(p->c.allocator, m);
+				lept_free_ex(&m->v, p->c.allocator);
+			}
+		}
+		if (f->has_key)
+			lept_member_free_key(p->c.allocator, &f->key);
+	}
+	if (p->has_root)
+		lept_free_ex(&p->root, p->c.allocator);
+	assert(p->c.top == 0);
+	p->has_root = 0;
+	p->state = LEPT_STATE_VALUE;
+	p->error = LEPT_PARSE_OK;
+}
+
+static void lept_parser_fail(lept_parser *p, int error) {
+	if (p->state == LEPT_STATE_STRING || p->state == LEPT_STATE_ESCAPE || p->state == LEPT_STATE_NUMBER)
+		p->c.top = p->head;
+	/* 未完成的 token 已经丢弃，清理时不再回退 */
+	p->state = LEPT_STATE_VALUE;
+	p->error = error;
+}
+
+/* 一个完整的值：成为根值，或者压入所在数组 / 对象 */
+static void lept_parser_add_value(lept_parser *p, lept_value *v) {
+	lept_parser_frame *f;
+	if (p->depth == 0) {
+		p->root = *v;
+		p->has_root = 1;
+		p->state = LEPT_STATE_END;
+		return;
+	}
+	f = &p->frames[p->depth - 1];
+	if (f->type == LEPT_ARRAY) {
+		lept_value *e = (lept_value *)lept_context_push(&p->c, sizeof(lept_value));
+		if (e == NULL) {
+			lept_free_ex(v, p->c.allocator);
+			lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+			return;
+		}
+		*e = *v;
+		p->state = LEPT_STATE_ARRAY_NEXT;
+	}
+	else {
+		lept_member *m = (lept_member *)lept_context_push(&p->c, sizeof(lept_member));
+		if (m == NULL) {
+			lept_free_ex(v, p->c.allocator);
+			lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+			return;
+		}
+		*m = f->key;
+		m->v = *v;
+		m->v.flags |= f->key.v.flags & LEPT_KEY_FLAGS;
+		f->has_key = 0;
+		p->state = LEPT_STATE_OBJECT_NEXT;
+	}
+	f->size++;
+}
+
+static void lept_parser_open(lept_parser *p, lept_type type) {
+	lept_parser_frame *f;
+	if (p->depth == p->frames_size) {
+		size_t n = p->frames_size == 0 ? 16 : p->frames_size + (p->frames_size >> 1);
+		lept_parser_frame *frames = (lept_parser_frame *)LEPT_REALLOC(p->c.allocator, p->frames, n * sizeof(lept_parser_frame));
+		if (frames == NULL) {
+			lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+			return;
+		}
+		p->frames = frames;
+		p->frames_size = n;
+	}
+	f = &p->frames[p->depth++];
+	f->type = type;
+	f->size = 0;
+	f->has_key = 0;
+	p->state = type == LEPT_ARRAY ? LEPT_STATE_ARRAY_FIRST : LEPT_STATE_OBJECT_FIRST;
+}
+
+static void lept_parser_close(lept_parser *p) {
+	lept_parser_frame *f = &p->frames[p->depth - 1];
+	lept_value v;
+	lept_init(&v);
+	/* 失败时这一层仍然打开，元素留在栈上由 lept_parser_clear() 释放 */
+	if (!(f->type == LEPT_ARRAY ? lept_context_pop_array(&p->c, &v, f->size) : lept_context_pop_object(&p->c, &v, f->size))) {
+		lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+		return;
+	}
+	p->depth--;
+	lept_parser_add_value(p, &v);
+}
+
+static int lept_number_next(int state, char ch) {
+	switch (state) {
+	case LEPT_NUM_MINUS:
+		return ch == '0' ? LEPT_NUM_ZERO : ISDIGIT1_9(ch) ? LEPT_NUM_INT : LEPT_NUM_STOP;
+	case LEPT_NUM_ZERO:
+	case LEPT_NUM_INT:
+		if (state == LEPT_NUM_INT && ISDIGIT0_9(ch))
+			return LEPT_NUM_INT;
+		return ch == '.' ? LEPT_NUM_DOT : (ch == 'e' || ch == 'E') ? LEPT_NUM_E : LEPT_NUM_STOP;
+	case LEPT_NUM_DOT:
+		return ISDIGIT0_9(ch) ? LEPT_NUM_FRAC : LEPT_NUM_STOP;
+	case LEPT_NUM_FRAC:
+		return ISDIGIT0_9(ch) ? LEPT_NUM_FRAC : (ch == 'e' || ch == 'E') ? LEPT_NUM_E : LEPT_NUM_STOP;
+	case LEPT_NUM_E:
+		return (ch == '+' || ch == '-') ? LEPT_NUM_ESIGN : ISDIGIT0_9(ch) ? LEPT_NUM_EXP : LEPT_NUM_STOP;
+	default:
+		return ISDIGIT0_9(ch) ? LEPT_NUM_EXP : LEPT_NUM_STOP;
+	}
+}
+
+/* 反斜杠之后收集到的 n 个字符是否已经足以让 lept_parse_escape 给出结果（成功或出错） */
+static int lept_escape_complete(const char *e, size_t n) {
+	size_t i;
+	unsigned u;
+	if (n == 0)
+		return 0;
+	if (e[0] != 'u')
+		return 1;
+	for (i = 1; i < n && i < 5; i++)
+		if (!ISHEX(e[i]))
+			return 1;
+	if (n < 5)
+		return 0;
+	lept_parse_hex4(e + 1, e + 5, &u);
+	if (u < 0xD800 || u > 0xDBFF)
+		return 1;
+	if ((n > 5 && e[5] != '\\') || (n > 6 && e[6] != 'u'))
+		return 1;
+	for (i = 7; i < n; i++)
+		if (!ISHEX(e[i]))
+			return 1;
+	return n == 11;
+}
+
+static void lept_parser_begin_value(lept_parser *p, char ch) {
+	switch (ch) {
+		case 'n': p->literal = "null"; p->literal_type = LEPT_NULL; break;
+		case 't': p->literal = "true"; p->literal_type = LEPT_TRUE; break;
+		case 'f': p->literal = "false"; p->literal_type = LEPT_FALSE; break;
+		case '\0': lept_parser_fail(p, LEPT_PARSE_EXPECT_VALUE); return;
+		case '\"':
+			p->head = p->c.top;
+			p->is_key = 0;
+			p->state = LEPT_STATE_STRING;
+			return;
+		case '[': lept_parser_open(p, LEPT_ARRAY); return;
+		case '{': lept_parser_open(p, LEPT_OBJECT); return;
 		default:
-			if ((unsigned char)ch < 0x20) {
-				STRING_ERROR(LEPT_PARSE_INVALID_STRING_CHAR);
+			p->num_state = ch == '-' ? LEPT_NUM_MINUS : lept_number_next(LEPT_NUM_MINUS, ch);
+			if (p->num_state == LEPT_NUM_STOP) {
+				lept_parser_fail(p, LEPT_PARSE_INVALID_VALUE);
+				return;
+			}
+			p->head = p->c.top;
+			if (!PUTC(&p->c, ch)) {
+				lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+				return;
+			}
+			p->state = LEPT_STATE_NUMBER;
+			return;
+	}
+	p->literal_i = 1;
+	p->state = LEPT_STATE_LITERAL;
+}
+
+static const char *lept_parser_string(lept_parser *p, const char *json, const char *end) {
+	lept_context *c = &p->c;
+	const char *q;
+	char *s;
+	size_t len;
+	q = lept_scan_string(json, end);
+	if (q != json && !PUTS(c, json, (size_t)(q - json))) {
+		lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+		return end;
+	}
+	if (q == end)
+		return end;
+	switch (*q) {
+	case '\"':
+		len = c->top - p->head;
+		s = (char *)lept_context_pop(c, len);
+		if (p->is_key) {
+			lept_parser_frame *f = &p->frames[p->depth - 1];
+			f->key.v.flags = 0;
+			if (!lept_member_set_key(c, &f->key, s, len)) {
+				lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+				break;
 			}
-			PUTC(c, ch);
+			f->has_key = 1;
+			p->state = LEPT_STATE_COLON;
 		}
+		else {
+			lept_value v;
+			lept_init(&v);
+			if (!lept_context_set_string(c, &v, s, len))
+				lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+			else
+				lept_parser_add_value(p, &v);
+		}
+		break;
+	case '\\':
+		p->nesc = 0;
+		p->state = LEPT_STATE_ESCAPE;
+		break;
+	case '\0':
+		lept_parser_fail(p, LEPT_PARSE_MISS_QUOTATION_MARK);
+		break;
+	default:
+		lept_parser_fail(p, LEPT_PARSE_INVALID_STRING_CHAR);
 	}
+	return q + 1;
+}
+
+static const char *lept_parser_escape(lept_parser *p, const char *json, const char *end) {
+	char buf[4];
+	size_t n;
+	int ret;
+	while (json < end && !lept_escape_complete(p->esc, p->nesc))
+		p->esc[p->nesc++] = *json++;
+	if (!lept_escape_complete(p->esc, p->nesc))
+		return json;
+	/* 输入中的 '\0' 表示结束，不属于转义序列 */
+	n = p->esc[p->nesc - 1] == '\0' ? p->nesc - 1 : p->nesc;
+	if (lept_parse_escape(p->esc, p->esc + n, buf, &n, &ret) == NULL)
+		lept_parser_fail(p, ret);
+	else if (!PUTS(&p->c, buf, n))
+		lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+	else
+		p->state = LEPT_STATE_STRING;
+	return json;
 }
 
-int lept_encode_utf8(lept_context *c, const unsigned u) {
-	if (u >= 0x0000 && u <= 0x007F) {
-		PUTC(c, u & 0x007F);
+static const char *lept_parser_number(lept_parser *p, const char *json, const char *end) {
+	lept_context *c = &p->c, t;
+	const char *q;
+	lept_value v;
+	size_t len;
+	int next, ret;
+	for (q = json; q < end && (next = lept_number_next(p->num_state, *q)) != LEPT_NUM_STOP; q++)
+		p->num_state = next;
+	if (q != json && !PUTS(c, json, (size_t)(q - json))) {
+		lept_parser_fail(p, LEPT_PARSE_OUT_OF_MEMORY);
+		return end;
 	}
-	else  if (u >= 0x0080 && u <= 0x07FF) {
-		PUTC(c, 0xC0 | ((u >> 6) & 0x001F));
-		PUTC(c, 0x80 | (u & 0x003F));
+	if (q == end)
+		return end;
+	/* 数字在 q 处结束，q 本身留给下一个状态 */
+	if (p->num_state != LEPT_NUM_ZERO && p->num_state != LEPT_NUM_INT && p->num_state != LEPT_NUM_FRAC && p->num_state != LEPT_NUM_EXP) {
+		lept_parser_fail(p, LEPT_PARSE_INVALID_VALUE);
+		return q;
 	}
-	else if (u >= 0x0800 && u <= 0xFFFF) {
-		PUTC(c, 0xE0 | ((u >> 12) & 0x000F));
-		PUTC(c, 0x80 | ((u >> 6) & 0x003F));
-		PUTC(c, 0x80 | (u & 0x003F));
+	len = c->top - p->head;
+	t.json = (const char *)lept_context_pop(c, len);
+	t.end = t.json + len;
+	lept_init(&v);
+	if ((ret = lept_parse_number(&t, &v)) != LEPT_PARSE_OK)
+		lept_parser_fail(p, ret);
+	else
+		lept_parser_add_value(p, &v);
+	return q;
+}
+
+/* 从 json 开始在当前状态下尽量多地消费输入，返回停下的位置 */
+static const char *lept_parser_run(lept_parser *p, const char *json, const char *end) {
+	char ch;
+	switch (p->state) {
+	case LEPT_STATE_STRING: return lept_parser_string(p, json, end);
+	case LEPT_STATE_ESCAPE: return lept_parser_escape(p, json, end);
+	case LEPT_STATE_NUMBER: return lept_parser_number(p, json, end);
+	case LEPT_STATE_LITERAL:
+		for (; json < end && p->literal[p->literal_i] != '\0'; json++, p->literal_i++)
+			if (*json != p->literal[p->literal_i]) {
+				lept_parser_fail(p, LEPT_PARSE_INVALID_VALUE);
+				return json;
+			}
+		if (p->literal[p->literal_i] == '\0') {
+			lept_value v;
+			lept_init(&v);
+			v.type = p->literal_type;
+			lept_parser_add_value(p, &v);
+		}
+		return json;
+	default:
+		break;
 	}
-	else if (u >= 0x10000 && u <= 0x10FFFF) {
-		PUTC(c, 0xF0 | ((u >> 18) & 0xFF));
-		PUTC(c, 0x80 | ((u >> 12) & 0x3F));
-		PUTC(c, 0x80 | ((u >> 6) & 0x3F));
-		PUTC(c, 0x80 | (u & 0x3F));
+	while (json < end && ISWHITESPACE(*json))
+		json++;
+	if (json == end)
+		return end;
+	ch = *json++;
+	switch (p->state) {
+	case LEPT_STATE_VALUE:
+		lept_parser_begin_value(p, ch);
+		break;
+	case LEPT_STATE_ARRAY_FIRST:
+		if (ch == ']')
+			lept_parser_close(p);
+		else
+			lept_parser_begin_value(p, ch);
+		break;
+	case LEPT_STATE_ARRAY_NEXT:
+		if (ch == ',')
+			p->state = LEPT_STATE_VALUE;
+		else if (ch == ']')
+			lept_parser_close(p);
+		else
+			lept_parser_fail(p, LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET);
+		break;
+	case LEPT_STATE_OBJECT_FIRST:
+	case LEPT_STATE_OBJECT_KEY:
+		if (ch == '}' && p->state == LEPT_STATE_OBJECT_FIRST)
+			lept_parser_close(p);
+		else if (ch == '\"') {
+			p->head = p->c.top;
+			p->is_key = 1;
+			p->state = LEPT_STATE_STRING;
+		}
+		else
+			lept_parser_fail(p, LEPT_PARSE_MISS_KEY);
+		break;
+	case LEPT_STATE_COLON:
+		if (ch == ':')
+			p->state = LEPT_STATE_VALUE;
+		else
+			lept_parser_fail(p, LEPT_PARSE_MISS_COLON);
+		break;
+	case LEPT_STATE_OBJECT_NEXT:
+		if (ch == ',')
+			p->state = LEPT_STATE_OBJECT_KEY;
+		else if (ch == '}')
+			lept_parser_close(p);
+		else
+			lept_parser_fail(p, LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET);
+		break;
+	case LEPT_STATE_END:
+		if (ch == '\0')
+			p->state = LEPT_STATE_DONE;
+		else
+			lept_parser_fail(p, LEPT_PARSE_ROOT_NOT_SINGULAR);
+		break;
 	}
-	else return LEPT_PARSE_INVALID_UNICODE_SURROGATE;
-	return LEPT_PARSE_OK;
+	return json;
 }
 
-size_t lept_get_array_size(const lept_value *v) {
-	assert(v != NULL && v->type == LEPT_ARRAY);
-	return v->u.arr.size;
+size_t lept_get_object_size(const lept_value *v) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_LAZY_LOAD(v, 0);
+	return v->u.o.size;
 }
 
-lept_value * lept_get_array_element(const lept_value *v, size_t n) {
-	assert(v != NULL && v->type == LEPT_ARRAY);
-	assert(n <= v->u.arr.size);
-	return &v->u.arr.e[n];
+const char *lept_get_object_key(const lept_value *v, const size_t size) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_LAZY_LOAD(v, NULL);
+	assert(size <= v->u.o.size);
+	return LEPT_KEY_DATA(&v->u.o.m[size]);
 }
 
-char *lept_parse_hex4(char *p, unsigned *u) {
-	size_t i;
-	*u = 0x00;
-	for (i = 0; i < 4; i++) {
-		if (!(ISHEX(*(p + i)))) {
-			return NULL;
+size_t lept_get_object_key_len(const lept_value *v, const size_t size) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_LAZY_LOAD(v, 0);
+	assert(size <= v->u.o.size);
+	return LEPT_KEY_LEN(&v->u.o.m[size]);
+}
+
+const lept_value *lept_get_object_value(const lept_value *v, const size_t size) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	LEPT_LAZY_LOAD(v, NULL);
+	assert(size <= v->u.o.size);
+	return &v->u.o.m[size].v;
+}
+
+/* FNV-1a */
+static uint32_t lept_hash_key(const char *k, size_t len) {
+	uint32_t h = 2166136261u;
+	while (len--) {
+		h ^= (unsigned char)*k++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/* 装载因子不超过 1/2 */
+static size_t lept_object_index_capacity(size_t size) {
+	size_t cap = 2;
+	while (cap < size * 2)
+		cap <<= 1;
+	return cap;
+}
+
+/* 按成员顺序插入，重复的键只保留第一个，与线性查找的结果一致；a 须是构造这棵树时用的分配器。
+ * 分配失败时返回 0，不建索引，查找照常线性扫描 */
+static int lept_object_build_index(const lept_value *v, const lept_allocator *a) {
+	lept_object_header *h = LEPT_OBJECT_HEADER_OF(v);
+	size_t mask = lept_object_index_capacity(v->u.o.size) - 1, i, j;
+	uint32_t *slots;
+	if (h->arena != NULL)
+		slots = (uint32_t *)lept_arena_alloc(h->arena, (mask + 1) * sizeof(uint32_t));
+	else
+		slots = (uint32_t *)LEPT_MALLOC(a, (mask + 1) * sizeof(uint32_t));
+	if (slots == NULL)
+		return 0;
+	memset(slots, 0, (mask + 1) * sizeof(uint32_t));
+	for (i = 0; i < v->u.o.size; i++) {
+		const lept_member *m = &v->u.o.m[i];
+		const char *k = LEPT_KEY_DATA(m);
+		size_t klen = LEPT_KEY_LEN(m);
+		uint32_t hash = m->v.flags & LEPT_KEY_INTERNED ? LEPT_SYMBOL_OF(k)->hash : lept_hash_key(k, klen);
+		for (j = hash & mask; slots[j] != 0; j = (j + 1) & mask) {
+			const lept_member *o = &v->u.o.m[slots[j] - 1];
+			if (LEPT_KEY_LEN(o) == klen && memcmp(LEPT_KEY_DATA(o), k, klen) == 0)
+				break;
 		}
-		else {
-			*u = *u << 4;
-			//*u += (*(p + i) - '0' >= 10) ? (*(p + i) - 'A' + 10) : (*(p + i) - '0');
-			if (*(p + i) >= '0' && *(p + i) <= '9')  *u += *(p + i) - '0';
-			else if (*(p + i) >= 'A' && *(p + i) <= 'F')  *u += *(p + i) - ('A' - 10);
-			else if (*(p + i) >= 'a' && *(p + i) <= 'f')  *u += *(p + i) - ('a' - 10);
-/* 如果使用strtol
-static const char* lept_parse_hex4(const char* p, unsigned* u) {
-	char* end;
-	*u = (unsigned)strtol(p, &end, 16);
-	return end == p + 4 ? end : NULL;
+		if (slots[j] == 0)
+			slots[j] = (uint32_t)(i + 1);
+	}
+	h->slots = slots;
+	return 1;
 }
-但这个实现会错误地接受 "\u 123" 这种不合法的 JSON，
-因为 strtol() 会跳过开始的空白。要解决的话，还需要检测第一个字符是否 [0-9A-Fa-f]，或者 !isspace(*p)*/
+
+/* 大对象的散列索引，还没有时尽量现在建立；返回 NULL 表示只能线性查找 */
+static const uint32_t *lept_object_slots(const lept_value *v) {
+	const lept_object_header *h;
+	if (!(v->flags & LEPT_OBJECT_HEADER))
+		return NULL;
+	h = LEPT_OBJECT_HEADER_OF(v);
+	if (h->slots == NULL && h->lazy_index)
+		lept_object_build_index(v, &lept_global_allocator);
+	return h->slots;
+}
+
+/* 大对象第一次查找时建立散列索引（不是线程安全的，多线程共享只读树时先用 LEPT_PARSE_FLAG_INDEX_OBJECTS 解析），
+ * 之后每次查找为 O(1)；小对象，以及用单独的分配器解析且没有指定 LEPT_PARSE_FLAG_INDEX_OBJECTS 的对象直接线性比较 */
+size_t lept_find_object_index(const lept_value *v, const char *key, size_t klen) {
+	const uint32_t *slots;
+	size_t i, mask;
+	assert(v != NULL && v->type == LEPT_OBJECT && (key != NULL || klen == 0));
+	LEPT_LAZY_LOAD(v, LEPT_KEY_NOT_EXIST);
+	if ((slots = lept_object_slots(v)) != NULL) {
+		mask = lept_object_index_capacity(v->u.o.size) - 1;
+		for (i = lept_hash_key(key, klen) & mask; slots[i] != 0; i = (i + 1) & mask) {
+			const lept_member *m = &v->u.o.m[slots[i] - 1];
+			if (LEPT_KEY_LEN(m) == klen && memcmp(LEPT_KEY_DATA(m), key, klen) == 0)
+				return slots[i] - 1;
 		}
+		return LEPT_KEY_NOT_EXIST;
 	}
-	return p += 4;
+	for (i = 0; i < v->u.o.size; i++)
+		if (LEPT_KEY_LEN(&v->u.o.m[i]) == klen && memcmp(LEPT_KEY_DATA(&v->u.o.m[i]), key, klen) == 0)
+			return i;
+	return LEPT_KEY_NOT_EXIST;
 }
 
-void lept_set_null(lept_value *v) {
-	assert(v != NULL);
-	lept_free(v);
-	v->type = LEPT_NULL;
+lept_value *lept_find_object_value(lept_value *v, const char *key, size_t klen) {
+	size_t index = lept_find_object_index(v, key, klen);
+	return index != LEPT_KEY_NOT_EXIST ? &v->u.o.m[index].v : NULL;
 }
 
-static int lept_parse_array(lept_context *c, lept_value *v) {
-	size_t size = 0, i;
+/* sym 是 lept_symtab_intern()/lept_symtab_find() 返回的规范副本，v 须用同一个表解析：
+ * 只比较指针，大对象的散列值也直接取自 sym，不再计算 */
+size_t lept_find_object_symbol(const lept_value *v, const char *sym) {
+	const uint32_t *slots;
+	size_t i, mask;
+	assert(v != NULL && v->type == LEPT_OBJECT && sym != NULL);
+	LEPT_LAZY_LOAD(v, LEPT_KEY_NOT_EXIST);
+	if ((slots = lept_object_slots(v)) != NULL) {
+		mask = lept_object_index_capacity(v->u.o.size) - 1;
+		for (i = LEPT_SYMBOL_OF(sym)->hash & mask; slots[i] != 0; i = (i + 1) & mask)
+			if (v->u.o.m[slots[i] - 1].k == sym)
+				return slots[i] - 1;
+		return LEPT_KEY_NOT_EXIST;
+	}
+	for (i = 0; i < v->u.o.size; i++)
+		if (v->u.o.m[i].k == sym)
+			return i;
+	return LEPT_KEY_NOT_EXIST;
+}
+
+/* 树中有解码失败的惰性节点时不输出，返回它的解码错误码（LEPT_PARSE_*），各个 stringify 函数都一样 */
+int lept_stringify(const lept_value *v, char **json, size_t *length) {
+	return lept_stringify_ex(v, json, length, NULL);
+}
+
+int lept_stringify_ex(const lept_value *v, char **json, size_t *length, const lept_stringify_options *opt) {
+	lept_context c;
 	int ret;
-	EXPECT(c, '[');
-	lept_parse_whitespace(c);
-	if (*c->json == ']') {
-		c->json++;
-		v->type = LEPT_ARRAY;
-		v->u.arr.size = 0;
-		v->u.arr.e = NULL;
-		return LEPT_PARSE_OK;
+	assert(v != NULL && json != NULL);
+	lept_simd_init();
+	c.stats = opt != NULL ? opt->stats : NULL;
+	c.allocator = opt != NULL && opt->allocator != NULL ? opt->allocator : &lept_global_allocator;
+	LEPT_STATS_BEGIN(&c);
+	*json = NULL;
+	if ((c.stack = (char *)LEPT_MALLOC(c.allocator, c.size = LEPT_PARSE_STRINGIFY_INIT_SIZE)) == NULL)
+		return LEPT_PARSE_OUT_OF_MEMORY;
+	LEPT_STATS_ADD(&c, mallocs, 1);
+	c.top = 0;
+	c.write = NULL;
+	c.error = 0;
+	ret = lept_stringify_value(&c, v);
+	LEPT_STATS_END(&c, c.top);
+	if (ret == LEPT_STRINGIFY_OK && !PUTC(&c, '\0'))
+		ret = LEPT_PARSE_OUT_OF_MEMORY;
+	if (ret != LEPT_STRINGIFY_OK) {
+		LEPT_FREE(c.allocator, c.stack);
+		return ret;
 	}
-	while (1) {
-		lept_value e;
-		lept_init(&e);
-		lept_parse_whitespace(c);
-		if (ret = lept_parse_value(c, &e) != LEPT_PARSE_OK)
-			break;
-		memcpy(lept_context_push(c, sizeof(lept_value)), &e, sizeof(lept_value));
-		size++;
-		lept_parse_whitespace(c);
-		if (*c->json == ',')
-			c->json++;
-		else if (*c->json == ']') {
-			c->json++;
-			v->type = LEPT_ARRAY;
-			v->u.arr.size = size;
-			size *= sizeof(lept_value);
-			memcpy(v->u.arr.e = (lept_value *)malloc(size), lept_context_pop(c, size), size);
-			return LEPT_PARSE_OK;
-		}
-		else {
-			ret = LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
-			break;
-		}
+	if (length)
+		*length = c.top - 1;
+	*json = c.stack;
+	return LEPT_STRINGIFY_OK;
+}
+
+/* 输出与 lept_stringify() 逐字节相同，但每积累最多 buf_size 字节就交给 write_fn，
+ * 不需要容纳整个文档的连续内存。write_fn 返回非 0 时停止并返回 LEPT_STRINGIFY_SINK_ERROR */
+int lept_stringify_to_sink(const lept_value *v, lept_write_fn write_fn, void *ctx, size_t buf_size) {
+	lept_context c;
+	int ret;
+	assert(v != NULL && write_fn != NULL);
+	lept_simd_init();
+	if (buf_size < LEPT_STRINGIFY_SINK_MIN_SIZE)
+		buf_size = LEPT_STRINGIFY_SINK_MIN_SIZE;
+	/* 多一个字节，栈恰好写满 buf_size 时 lept_context_push 也不会扩容 */
+	c.stats = NULL;
+	c.allocator = &lept_global_allocator;
+	if ((c.stack = (char *)LEPT_MALLOC(c.allocator, c.size = buf_size + 1)) == NULL)
+		return LEPT_PARSE_OUT_OF_MEMORY;
+	c.top = 0;
+	c.write = write_fn;
+	c.write_ctx = ctx;
+	c.flush_size = buf_size;
+	c.error = 0;
+	if ((ret = lept_stringify_value(&c, v)) == LEPT_STRINGIFY_OK) {
+		lept_stringify_flush(&c);
+		if (c.error != 0)
+			ret = c.error;
 	}
-	/* Pop and free values on the stack */
-	for (i = 0; i < size; i++)
-		lept_free((lept_value*)lept_context_pop(c, sizeof(lept_value)));
-	v->type = LEPT_VOID;
+	LEPT_FREE(c.allocator, c.stack);
 	return ret;
 }
-/*
-我们把这个指针调用 lept_parse_value(c, e)，
-这里会出现问题，因为 lept_parse_value() 及之下的函数都需要调用 lept_context_push()，
-而 lept_context_push() 在发现栈满了的时候会用 realloc() 扩容。
-这时候，我们上层的 e 就会失效，变成一个悬挂指针（dangling pointer），
-而且 lept_parse_value(c, e) 会通过这个指针写入解析结果，造成非法访问。
-在使用 C++ 容器时，也会遇到类似的问题。从容器中取得的迭代器（iterator）后，
-如果改动容器内容，之前的迭代器会失效。这里的悬挂指针问题也是相同的。
 
-但这种 bug 有时可能在简单测试中不能自动发现，因为问题只有堆栈满了才会出现。
-从测试的角度看，我们需要一些压力测试（stress test），测试更大更复杂的数据。
-但从编程的角度看，我们要谨慎考虑变量的生命周期，尽量从编程阶段避免出现问题
+struct lept_writer {
+	lept_context c;
+	size_t retain;
+};
 
-例如把 lept_context_push() 的 API 改为：
-static void lept_context_push(
-lept_context* c, const void* data, size_t size);
+lept_writer *lept_writer_create(void) {
+	lept_writer *w = (lept_writer *)LEPT_MALLOC(&lept_global_allocator, sizeof(lept_writer));
+	assert(w != NULL);
+	w->c.stack = NULL;
+	w->c.size = w->c.top = 0;
+	w->c.stats = NULL;
+	w->c.allocator = &lept_global_allocator;
+	w->c.write = NULL;
+	w->retain = LEPT_RETAIN_SIZE;
+	return w;
+}
 
-这样就确把数据压入栈内，避免了返回指针的生命周期问题。但我们之后会发现，原来的 API 设计在一些情况会更方便一些，
-例如在把字符串值转化（stringify）为 JSON 时，我们可以预先在堆栈分配字符串所需的最大空间，而当时是未有数据填充进去的。
-无论如何，我们编程时都要考虑清楚变量的生命周期，特别是指针的生命周期。
-*/
+void lept_writer_destroy(lept_writer *w) {
+	if (w == NULL)
+		return;
+	LEPT_FREE(w->c.allocator, w->c.stack);
+	LEPT_FREE(&lept_global_allocator, w);
+}
 
-static int lept_parse_object(lept_context *c, lept_value *v) {
+/* 输出与 lept_stringify() 相同，但写在 writer 保留的缓冲区中（以 '\0' 结尾），
+ * 到下一次 lept_writer_write()/lept_writer_trim()/lept_writer_destroy() 之前有效 */
+int lept_writer_write(lept_writer *w, const lept_value *v, const char **json, size_t *length) {
 	int ret;
-	size_t size, i;
-	lept_member m;
-	EXPECT(c, '{');
-	lept_parse_whitespace(c);
-	if (*c->json == '}') {
-		c->json++;
-		v->type = LEPT_OBJECT;
-		v->u.o.m = 0;
-		v->u.o.size = 0;
-		return LEPT_PARSE_OK;
+	assert(w != NULL && v != NULL && json != NULL);
+	lept_simd_init();
+	/* 上一次的输出到这里才用完，这时再按保留策略处理缓冲区 */
+	if (w->c.size > w->retain)
+		lept_writer_trim(w);
+	w->c.top = 0;
+	w->c.error = 0;
+	if ((ret = lept_stringify_value(&w->c, v)) == LEPT_STRINGIFY_OK && !PUTC(&w->c, '\0'))
+		ret = LEPT_PARSE_OUT_OF_MEMORY;
+	if (ret != LEPT_STRINGIFY_OK) {
+		*json = NULL;
+		return ret;
+	}
+	if (length)
+		*length = w->c.top - 1;
+	*json = (const char *)w->c.stack;
+	return LEPT_STRINGIFY_OK;
+}
+
+/* 同 lept_parser_set_retain() */
+void lept_writer_set_retain(lept_writer *w, size_t bytes) {
+	assert(w != NULL);
+	w->retain = bytes;
+}
+
+void lept_writer_trim(lept_writer *w) {
+	assert(w != NULL);
+	LEPT_FREE(w->c.allocator, w->c.stack);
+	w->c.stack = NULL;
+	w->c.size = w->c.top = 0;
+}
+
+/* ctx 为 FILE * */
+int lept_file_sink(void *ctx, const char *buf, size_t len) {
+	return fwrite(buf, 1, len, (FILE *)ctx) == len ? 0 : -1;
+}
+
+/* ctx 指向文件描述符（int） */
+int lept_fd_sink(void *ctx, const char *buf, size_t len) {
+	int fd = *(const int *)ctx;
+	while (len > 0) {
+#ifdef _WIN32
+		int n = _write(fd, buf, len > 0x40000000 ? 0x40000000u : (unsigned)len);
+#else
+		ssize_t n = write(fd, buf, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+#endif
+		if (n <= 0)
+			return -1;
+		buf += n;
+		len -= (size_t)n;
 	}
-	m.k = NULL;
-	size = 0;
+	return 0;
+}
+
+/* 在栈上占出 size 字节：输出到 sink 时不够就先把已有内容交出去。
+ * 分配失败时记下 LEPT_PARSE_OUT_OF_MEMORY 并返回 NULL，与 sink 出错一样由 lept_stringify_value() 在下一步停下 */
+static char *lept_stringify_reserve(lept_context *c, size_t size) {
+	char *p;
+	if (c->write != NULL && c->top + size > c->flush_size)
+		lept_stringify_flush(c);
+	if ((p = (char *)lept_context_push(c, size)) == NULL && c->error == 0)
+		c->error = LEPT_PARSE_OUT_OF_MEMORY;
+	return p;
+}
+
+static void lept_stringify_flush(lept_context *c) {
+	if (c->top > 0 && c->error == 0 && c->write(c->write_ctx, (const char *)c->stack, c->top) != 0)
+		c->error = LEPT_STRINGIFY_SINK_ERROR;
+	c->top = 0;
+}
+
+/* 不递归：用 lept_walk 记录各层输出到第几个元素 / 成员 */
+static int lept_stringify_value(lept_context *c, const lept_value *v) {
+	lept_walk w;
+	int ret = LEPT_STRINGIFY_OK, err;
+	lept_walk_init(&w, c->allocator);
 	while (1) {
-		char* str;
-		lept_init(&m.v);
-		lept_parse_whitespace(c);
-		if (*c->json != '"') {
-			ret = LEPT_PARSE_MISS_KEY;
+		if (c->error != 0) {
+			ret = c->error;
 			break;
 		}
-		if ((ret = lept_parse_string_raw(c, &str, &m.klen)) != LEPT_PARSE_OK)
-			break;
-		memcpy(m.k = (char*)malloc(m.klen + 1), str, m.klen);
-		m.k[m.klen] = '\0';
-		lept_parse_whitespace(c);
-		if (*c->json != ':') {
-			ret = LEPT_PARSE_MISS_COLON;
+		LEPT_STATS_ADD(c, values[v->type], 1);
+		if ((v->flags & LEPT_VALUE_LAZY) && (err = lept_lazy_load((lept_value *)v)) != LEPT_PARSE_OK) {
+			ret = err;
 			break;
 		}
-		c->json++;
-		lept_parse_whitespace(c);
-		if ((ret = lept_parse_value(c, &m.v)) != LEPT_PARSE_OK)
-			break;
-		memcpy(lept_context_push(c, sizeof(lept_member)), &m, sizeof(lept_member));
-		size++;
-		m.k = NULL;
-		lept_parse_whitespace(c);
-		if (*c->json == ',')
-			c->json++;
-		else if (*c->json == '}') {
-			c->json++;
-			v->type = LEPT_OBJECT;
-			v->u.o.size = size;
-			size *= sizeof(lept_member);
-			memcpy(v->u.o.m = (lept_member *)malloc(size), lept_context_pop(c, size), size);
-			return LEPT_PARSE_OK;
+		switch (v->type) {
+			case LEPT_NULL: lept_stringify_raw(c, "null", 4); break;
+			case LEPT_FALSE: lept_stringify_raw(c, "false", 5); break;
+			case LEPT_TRUE: lept_stringify_raw(c, "true", 4); break;
+			case LEPT_NUMBER: {
+				char *buffer;
+				if ((buffer = lept_stringify_reserve(c, 32)) == NULL)
+					break;
+				LEPT_STATS_TIMED(c, number_ns, c->top -= 32 - (size_t)(lept_write_double(buffer, v->u.n) - buffer));
+				break;
+			}
+			case LEPT_STRING: LEPT_STATS_TIMED(c, string_ns, lept_stringify_string(c, LEPT_STRING_DATA(v), LEPT_STRING_LEN(v))); break;
+			case LEPT_ARRAY:
+			case LEPT_OBJECT:
+				lept_stringify_raw(c, v->type == LEPT_ARRAY ? "[" : "{", 1);
+				if (LEPT_CHILD_COUNT(v) != 0) {
+					if (!lept_walk_push(&w, v)) {
+						ret = LEPT_PARSE_OUT_OF_MEMORY;
+						goto done;
+					}
+					LEPT_STATS_MAX(c, max_depth, w.depth);
+					v = lept_stringify_child(c, v, 0);
+					continue;
+				}
+				lept_stringify_raw(c, v->type == LEPT_ARRAY ? "]" : "}", 1);
+				break;
+			default: assert(0 && "invalid type");
 		}
-		else {
-			ret = LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
-			break;
+		/* v 已经输出完：接着输出所在容器的下一个子节点，或者闭合容器 */
+		while (w.depth > 0) {
+			lept_walk_frame *f = &w.frames[w.depth - 1];
+			if (++f->i < LEPT_CHILD_COUNT(f->v))
+				break;
+			lept_stringify_raw(c, f->v->type == LEPT_ARRAY ? "]" : "}", 1);
+			w.depth--;
 		}
+		if (w.depth == 0)
+			break;
+		lept_stringify_raw(c, ",", 1);
+		v = lept_stringify_child(c, w.frames[w.depth - 1].v, w.frames[w.depth - 1].i);
 	}
-	free(m.k);
-	for (i = 0; i < size; i++) {
-		lept_member *m;
-		m = (lept_member *)lept_context_pop(c, sizeof(lept_member));
-		free(m->k);
-		lept_free(&(m->v));
-	}
-	v->type = LEPT_VOID;
+	/* 出错之后的输出都跳过了，最后一个值出错时循环照常走完 */
+	if (ret == LEPT_STRINGIFY_OK && c->error != 0)
+		ret = c->error;
+done:
+	lept_walk_free(&w);
 	return ret;
 }
 
-size_t lept_get_object_size(const lept_value *v) {
-	assert(v != NULL && v->type == LEPT_OBJECT);
-	return v->u.o.size;
+/* 返回容器 v 的第 i 个子节点；对象的成员先输出键和 ':' */
+static const lept_value *lept_stringify_child(lept_context *c, const lept_value *v, size_t i) {
+	const lept_member *m;
+	if (v->type == LEPT_ARRAY)
+		return &v->u.arr.e[i];
+	m = &v->u.o.m[i];
+	LEPT_STATS_TIMED(c, string_ns, lept_stringify_string(c, LEPT_KEY_DATA(m), LEPT_KEY_LEN(m)));
+	lept_stringify_raw(c, ":", 1);
+	return &m->v;
 }
 
-const char *lept_get_object_key(const lept_value *v, const size_t size) {
-	assert(v != NULL && v->type == LEPT_OBJECT && size <= v->u.o.size);
-	return v->u.o.m[size].k;
+/* 原样输出；写入 sink 时超过缓冲区的内容分段 */
+static void lept_stringify_raw(lept_context *c, const char *s, size_t len) {
+	size_t n;
+	char *p;
+	while (len > 0) {
+		n = c->write != NULL && len > c->flush_size ? c->flush_size : len;
+		if ((p = lept_stringify_reserve(c, n)) == NULL)
+			return;
+		memcpy(p, s, n);
+		s += n;
+		len -= n;
+	}
+}
+
+/* 先数出实际要转义的字节，按转义后的确切长度预留一次，不需要转义的片段整段复制；
+ * 短字符串（多数键）按最坏情况预留也不多，省掉计数的一遍 */
+static void lept_stringify_string(lept_context *c, const char *s, size_t len) {
+	size_t size, piece, n;
+	char *head, *p;
+	assert(s != NULL);
+	size = (len < LEPT_ESCAPE_COUNT_SIZE ? len * 6 : lept_escaped_size(s, len)) + 2;
+	if (c->write == NULL || size <= c->flush_size) {
+		if ((p = head = lept_stringify_reserve(c, size)) == NULL)
+			return;
+		*p++ = '\"';
+		p = lept_write_escaped(p, s, len);
+		*p++ = '\"';
+		c->top -= size - (size_t)(p - head);
+		return;
+	}
+	/* 写入 sink 且放不进缓冲区时按最坏情况（每字节转义成 6 个字符）分段，每段都放得进缓冲区 */
+	piece = c->flush_size / 6;
+	lept_stringify_raw(c, "\"", 1);
+	while (len > 0) {
+		n = len < piece ? len : piece;
+		if ((p = lept_stringify_reserve(c, n * 6)) == NULL)
+			return;
+		c->top -= n * 6 - (size_t)(lept_write_escaped(p, s, n) - p);
+		s += n;
+		len -= n;
+	}
+	lept_stringify_raw(c, "\"", 1);
 }
 
-const size_t lept_get_object_key_len(const lept_value *v, const size_t size) {
-	assert(v != NULL && v->type == LEPT_OBJECT && size <= v->u.o.size);
-	return v->u.o.m[size].klen;
+/* 需要转义的字节（'"'、'\\' 和控制字符）在反斜杠之后的字符，'u' 表示输出 \u00XX */
+static char lept_escape_char(unsigned char ch) {
+	switch (ch) {
+		case '\"': return '\"';
+		case '\\': return '\\';
+		case '\b': return 'b';
+		case '\f': return 'f';
+		case '\n': return 'n';
+		case '\r': return 'r';
+		case '\t': return 't';
+		default: return 'u';
+	}
 }
 
-const lept_value *lept_get_object_value(const lept_value *v, const size_t size) {
-	assert(v != NULL && v->type == LEPT_OBJECT && size <= v->u.o.size);
-	return &v->u.o.m[size].v;
+/* 需要转义的正好是 lept_scan_string 停下的字节，向量内核一次跳过一整段；不足一个向量时直接用标量版本 */
+static size_t lept_escaped_size(const char *s, size_t len) {
+	const char *end = s + len;
+	size_t size = len;
+	while ((s = end - s < 16 ? lept_scan_string_scalar(s, end) : lept_scan_string(s, end)) != end)
+		size += lept_escape_char((unsigned char)*s++) == 'u' ? 5 : 1;
+	return size;
 }
 
-int lept_stringify(const lept_value *v, char **json, size_t *length) {
-	lept_context c;
-	int ret;
-	assert(v != NULL && json != NULL);
-	c.stack = (char *)malloc(c.size = LEPT_PARSE_STRINGIFY_INIT_SIZE);
-	c.top = 0;
-	if ((ret = lept_stringify_value(&c, v)) != LEPT_STRINGIFY_OK) {
-		free(c.stack);
-		*json = NULL;
-		return ret;
+static char *lept_write_escaped(char *p, const char *s, size_t len) {
+	static const char hex_digital[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+	const char *end = s + len, *q;
+	unsigned char ch;
+	while (s != end) {
+		/* 长的片段由向量内核找到下一个要转义的字节后整段复制；不足一个向量时逐字节处理，免得为几个字节调用 memcpy */
+		if (end - s >= 16) {
+			q = lept_scan_string(s, end);
+			memcpy(p, s, (size_t)(q - s));
+			p += q - s;
+			if ((s = q) == end)
+				break;
+		}
+		ch = (unsigned char)*s++;
+		if (ch >= 0x20 && ch != '\"' && ch != '\\') {
+			*p++ = (char)ch;
+			continue;
+		}
+		*p++ = '\\';
+		if ((*p++ = lept_escape_char(ch)) == 'u') {
+			*p++ = '0';
+			*p++ = '0';
+			*p++ = hex_digital[ch >> 4];
+			*p++ = hex_digital[ch & 15];
+		}
 	}
-	if (length)
-		*length = c.top;
-	PUTC(&c, '\0');
-	*json = c.stack;
-	return LEPT_STRINGIFY_OK;
+	return p;
 }
 
-static int lept_stringify_value(lept_context *c, const lept_value *v) {
-	size_t i;
-	switch (v->type) {
-		case LEPT_NULL: PUTS(c, "null", 4); break;
-		case LEPT_FALSE: PUTS(c, "false", 5); break;
-		case LEPT_TRUE: PUTS(c, "true", 4); break;
-		case LEPT_NUMBER: c->top -= 32 - sprintf(lept_context_push(c, 32), "%.17g", v->u.n); break;
-	  /*{
-			char* buffer = lept_context_push(c, 32);
-			int length = sprintf(buffer, "%.17g", v->u.n);
-			c->top -= 32 - length;
-		}*/
-		case LEPT_STRING: lept_stringify_string(c, v->u.s.s, v->u.s.len); break;
-		case LEPT_ARRAY: 
-			PUTC(c, '['); 
-			for (i = 0; i < v->u.arr.size; i++) {
-				lept_stringify_value(c, &v->u.arr.e[i]);
-				if (i != v->u.arr.size - 1)
-					PUTC(c, ',');
-			}
-			PUTC(c, ']'); 
-			break;
-		case LEPT_OBJECT: 
-			PUTC(c, '{'); 
-			for (i = 0; i < v->u.o.size; i++) {
-				PUTC(c, '"');
-				PUTS(c, v->u.o.m[i].k, v->u.o.m[i].klen);
-				PUTC(c, '"');
-				// lept_stringify_string(c, v->u.o.m[i].k, v->u.o.m[i].klen);
-				PUTC(c, ':');
-				lept_stringify_value(c, &v->u.o.m[i].v);
-				if (i != v->u.o.size - 1) 
-					PUTC(c, ',');
-			}
-			PUTC(c, '}');
+/* 分配失败时返回 NULL */
+static void *lept_context_alloc(lept_context *c, size_t size) {
+	if (c->arena != NULL)
+		return lept_arena_alloc(c->arena, size);
+	LEPT_STATS_ADD(c, mallocs, 1);
+	return LEPT_MALLOC(c->allocator, size);
+}
+
+#ifdef LEPT_STATS
+static uint64_t lept_stats_now(const lept_context *c) {
+#ifdef _WIN32
+	LARGE_INTEGER t, f;
+	if (c->stats == NULL)
+		return 0;
+	QueryPerformanceCounter(&t);
+	QueryPerformanceFrequency(&f);
+	return (uint64_t)((double)t.QuadPart * 1e9 / (double)f.QuadPart);
+#else
+	struct timespec ts;
+	if (c->stats == NULL)
+		return 0;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* 计数清零；structural_ns 先暂存开始时间，结束时再减去字符串和数字的耗时 */
+static void lept_stats_begin(lept_context *c) {
+	if (c->stats != NULL) {
+		memset(c->stats, 0, sizeof(lept_stats));
+		c->stats->structural_ns = lept_stats_now(c);
+	}
+}
+
+static void lept_stats_end(lept_context *c, size_t bytes) {
+	lept_stats *s = c->stats;
+	if (s != NULL) {
+		s->bytes = bytes;
+		s->structural_ns = lept_stats_now(c) - s->structural_ns - s->string_ns - s->number_ns;
+	}
+}
+#endif
+
+/* 之后的所有分配都经过 a（复制一份），NULL 恢复为 malloc()/realloc()/free()。
+ * 不是线程安全的，应在程序开始时、还没有任何树或解析器存在时调用 */
+void lept_set_allocator(const lept_allocator *a) {
+	if (a != NULL) {
+		assert(a->malloc_fn != NULL && a->realloc_fn != NULL && a->free_fn != NULL);
+		lept_global_allocator = *a;
+	}
+	else {
+		lept_global_allocator.malloc_fn = lept_std_malloc;
+		lept_global_allocator.realloc_fn = lept_std_realloc;
+		lept_global_allocator.free_fn = lept_std_free;
+		lept_global_allocator.ctx = NULL;
+	}
+}
+
+void lept_arena_init(lept_arena *a, size_t chunk_size) {
+	assert(a != NULL);
+	a->head = a->cur = NULL;
+	a->chunk_size = chunk_size != 0 ? chunk_size : LEPT_ARENA_CHUNK_SIZE;
+}
+
+/* 申请新块失败时返回 NULL */
+static void *lept_arena_alloc(lept_arena *a, size_t size) {
+	lept_arena_chunk *k;
+	void *ret;
+	size = LEPT_ARENA_ALIGN(size);
+	/* 先尝试当前块及 reset 后保留下来的后续块，都放不下才向系统申请新块 */
+	for (k = a->cur; k != NULL; k = k->next) {
+		if (k->size - k->top >= size)
 			break;
-		default: assert(0 && "invalid type");
+		if (k->next != NULL)
+			k->next->top = 0;
 	}
-	return LEPT_STRINGIFY_OK;
+	if (k == NULL) {
+		size_t n = size > a->chunk_size ? size : a->chunk_size;
+		if ((k = (lept_arena_chunk *)LEPT_MALLOC(&lept_global_allocator, LEPT_ARENA_ALIGN(sizeof(lept_arena_chunk)) + n)) == NULL)
+			return NULL;
+		k->size = n;
+		k->top = 0;
+		k->next = NULL;
+		if (a->cur != NULL) {
+			lept_arena_chunk *tail = a->cur;
+			while (tail->next != NULL)
+				tail = tail->next;
+			tail->next = k;
+		}
+		else
+			a->head = k;
+	}
+	a->cur = k;
+	ret = (char *)k + LEPT_ARENA_ALIGN(sizeof(lept_arena_chunk)) + k->top;
+	k->top += size;
+	return ret;
 }
 
-static void lept_stringify_string(lept_context *c, const char *s, size_t len) {
-	static const char hex_digital[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
-	size_t i, size;
-	char *head, *p;
-	assert(s != NULL);
-	p = head = lept_context_push(c, size = len * 6 + 2); // \u00xx
-	*p++ = '"';
-	for (i = 0; i < len; i++) {
-		unsigned char ch = (unsigned char)s[i];
-		switch (ch) {
-			case '\n': *p++ = '\\'; *p++ = 'n'; break;
-			case '\\': *p++ = '\\'; *p++ = '\\'; break;
-			case '\b': *p++ = '\\'; *p++ = 'b';  break;
-			case '\f': *p++ = '\\'; *p++ = 'f';  break;
-			case '\r': *p++ = '\\'; *p++ = 'r';  break;
-			case '\t': *p++ = '\\'; *p++ = 't';  break;
-			case '\"': *p++ = '\\'; *p++ = '\"';  break;
-			//case '\/': *p++ = '\\'; *p++ = '\/';  break;
-			default : 
-				if (ch < 0x20) {
-					*p++ = '\\'; *p++ = 'u'; *p++ = '0'; *p++ = '0';
-					*p++ = hex_digital[ch >> 4];
-					*p++ = hex_digital[ch & 15];
-				}
-				else *p++ = s[i];
+/* 保留所有块以便复用，稳态下解析不再向系统申请内存 */
+void lept_arena_reset(lept_arena *a) {
+	assert(a != NULL);
+	a->cur = a->head;
+	if (a->head != NULL)
+		a->head->top = 0;
+}
+
+void lept_arena_free(lept_arena *a) {
+	lept_arena_chunk *k, *next;
+	assert(a != NULL);
+	for (k = a->head; k != NULL; k = next) {
+		next = k->next;
+		LEPT_FREE(&lept_global_allocator, k);
+	}
+	a->head = a->cur = NULL;
+}
+
+/* Schubfach（Giulietti）：在 v 的舍入区间内找位数最少、且离 v 最近的十进制数 digits * 10^exp10 */
+static void lept_schubfach(uint64_t bits, uint64_t *digits, int *exp10) {
+	uint64_t ieee_m = bits & ((1ULL << 52) - 1), c, cbl, cb, cbr, vbl, vb, vbr, lower, upper, s;
+	unsigned ieee_e = (unsigned)(bits >> 52) & 0x7FF;
+	const uint64_t *t;
+	uint64_t g[2];
+	int q, k, h, is_even, lower_closer, u_inside, w_inside;
+	if (ieee_e != 0) {
+		c = ieee_m | (1ULL << 52);
+		q = (int)ieee_e - 1075;
+	}
+	else {
+		c = ieee_m;
+		q = -1074;
+	}
+	is_even = (c & 1) == 0;
+	/* 2 的整数次幂与下一个较小 double 的间距只有一半 */
+	lower_closer = ieee_m == 0 && ieee_e > 1;
+	cbl = 4 * c - 2 + (uint64_t)lower_closer;
+	cb = 4 * c;
+	cbr = 4 * c + 2;
+	/* floor(log10(2^q)) 或 floor(log10(3/4 * 2^q)) */
+	k = lower_closer ? (q * 1262611 - 524031) >> 22 : (q * 1262611) >> 22;
+	/* floor(log2(10^-k)) */
+	h = q + ((-k * 1741647) >> 19) + 1;
+	/* 需要 10^-k 的上界：表中 -27 <= q < 0 的项已经向上取整，其余为截断值 */
+	t = lept_pow5_128[-k - LEPT_POW5_MIN];
+	g[0] = t[0];
+	g[1] = t[1];
+	if (-k >= 0 || -k < -27)
+		if (++g[1] == 0)
+			g[0]++;
+	vbl = lept_round_to_odd(g, cbl << h);
+	vb = lept_round_to_odd(g, cb << h);
+	vbr = lept_round_to_odd(g, cbr << h);
+	lower = vbl + !is_even;
+	upper = vbr - !is_even;
+	s = vb / 4;
+	if (s >= 10) {
+		uint64_t sp = s / 10;
+		int up_inside = lower <= 40 * sp, wp_inside = 40 * sp + 40 <= upper;
+		if (up_inside != wp_inside) {
+			*digits = sp + (uint64_t)wp_inside;
+			*exp10 = k + 1;
+			return;
+		}
+	}
+	u_inside = lower <= 4 * s;
+	w_inside = 4 * s + 4 <= upper;
+	if (u_inside != w_inside)
+		*digits = s + (uint64_t)w_inside;
+	else {
+		uint64_t mid = 4 * s + 2;
+		*digits = s + (uint64_t)(vb > mid || (vb == mid && (s & 1) != 0));
+	}
+	*exp10 = k;
+}
+
+/* floor(g * cp / 2^128)，丢弃的部分非零时把最低位置 1（向奇数舍入） */
+static uint64_t lept_round_to_odd(const uint64_t *g, uint64_t cp) {
+	uint64_t x1, y0, y1;
+	lept_umul128(g[1], cp, &x1);
+	y0 = lept_umul128(g[0], cp, &y1);
+	y0 += x1;
+	y1 += y0 < x1;
+	return y1 | (y0 > 1);
+}
+
+static char *lept_write_uint64(char *p, uint64_t u) {
+	char buf[20];
+	int n = 0;
+	do {
+		buf[n++] = (char)('0' + u % 10);
+		u /= 10;
+	} while (u != 0);
+	while (n > 0)
+		*p++ = buf[--n];
+	return p;
+}
+
+/* 与 "%.17g" 的格式规则一致（10 进制指数在 [-4, 17) 内用定点，否则用科学计数法），但只输出最短的能往返的数字 */
+static char *lept_write_double(char *p, double d) {
+	uint64_t bits, digits;
+	int exp10, n, e, i;
+	char buf[20];
+	memcpy(&bits, &d, sizeof(bits));
+	if ((bits & LEPT_DOUBLE_INF_BITS) == LEPT_DOUBLE_INF_BITS) {
+		/* JSON 无法表示 inf/nan */
+		memcpy(p, "null", 4);
+		return p + 4;
+	}
+	if (bits >> 63)
+		*p++ = '-';
+	bits &= ~(1ULL << 63);
+	memcpy(&d, &bits, sizeof(d));
+	/* 2^53 以内的整数都能精确表示，相邻 double 的间距不超过 1，整数本身就是最短表示 */
+	if (d <= (double)LEPT_DOUBLE_EXACT_INT && d == (double)(uint64_t)d)
+		return lept_write_uint64(p, (uint64_t)d);
+	lept_schubfach(bits, &digits, &exp10);
+	while (digits % 10 == 0) {
+		digits /= 10;
+		exp10++;
+	}
+	for (n = 0; digits != 0; digits /= 10)
+		buf[n++] = (char)('0' + digits % 10);
+	e = exp10 + n - 1;
+	if (e >= -4 && e < 17) {
+		if (e < 0) {
+			*p++ = '0';
+			*p++ = '.';
+			for (i = -1; i > e; i--)
+				*p++ = '0';
+			while (n > 0)
+				*p++ = buf[--n];
+		}
+		else {
+			for (i = 0; n > 0; i++) {
+				if (i == e + 1)
+					*p++ = '.';
+				*p++ = buf[--n];
+			}
+			for (; i <= e; i++)
+				*p++ = '0';
 		}
+		return p;
 	}
-	*p++ = '"';
-	c->top -= size - (p - head);
-}
\ No newline at end of file
+	*p++ = buf[--n];
+	if (n > 0) {
+		*p++ = '.';
+		while (n > 0)
+			*p++ = buf[--n];
+	}
+	*p++ = 'e';
+	*p++ = e < 0 ? '-' : '+';
+	if (e < 0)
+		e = -e;
+	if (e < 10)
+		*p++ = '0';
+	return lept_write_uint64(p, (uint64_t)e);
+}
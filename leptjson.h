@@ -2,6 +2,7 @@
 #define LEPTJSON_H__
 
 #include <stddef.h> // size_t
+#include <stdint.h> // uint32_t uint64_t
 
 typedef enum { LEPT_NULL, LEPT_FALSE, LEPT_TRUE, LEPT_NUMBER, LEPT_STRING, LEPT_ARRAY, LEPT_OBJECT, LEPT_VOID}lept_type;
 
@@ -20,51 +21,216 @@ enum {
 	LEPT_PARSE_MISS_KEY,
 	LEPT_PARSE_MISS_COLON,
 	LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET,
+	LEPT_PARSE_SAX_ABORTED, // lept_sax_handler 或 lept_query_fn 回调返回了 0
+	LEPT_PARSE_IO_ERROR, // lept_parse_file 无法打开或映射文件
+	LEPT_PARSE_DEPTH_EXCEEDED, // 嵌套超过 lept_parse_options.max_depth
+	LEPT_PARSE_INVALID_UTF8, // 设置了 LEPT_PARSE_FLAG_VALIDATE_UTF8 时，字符串中出现了不合法的 UTF-8 序列
+	LEPT_PARSE_OUT_OF_MEMORY, // 分配器返回了 NULL；解析和 stringify 都可能返回
 	LEPT_STRINGIFY_OK,
+	LEPT_STRINGIFY_SINK_ERROR, // sink 的 write_fn 返回了非 0
 };
 
 typedef struct lept_value lept_value;
 typedef struct lept_member lept_member;
 // 由于 lept_value 内使用了自身类型的指针，我们必须前向声明（forward declare）此类型
 
+/* 定义 LEPT_COMPACT 后，长度和个数只用 32 位，type 只占一个字节，并按 4 字节对齐紧凑排列：
+ * 64 位平台上 lept_value 从 24 字节降到 16 字节，lept_member 从 40 字节降到 28 字节。
+ * 此时单个字符串、数组或对象的长度不能超过 2^32 - 1。字段名不变，访问函数的行为也不变。
+ * 短字符串和短键直接存放在 u.s / k、klen 所占的字节中（见 leptjson.c），请通过 lept_get_string() 等函数读取，
+ * 得到的指针指向节点内部，节点被移动或释放后失效 */
+#ifdef LEPT_COMPACT
+typedef uint32_t lept_size;
+#pragma pack(push, 4)
+#else
+typedef size_t lept_size;
+#endif
+
 struct lept_value {
 	union {
 		struct {
 			lept_member *m;
-			size_t size;
+			lept_size size;
 		}o;
 		struct {
 			lept_value *e;
-			size_t size; // size 是元素的个数，不是字节单位
+			lept_size size; // size 是元素的个数，不是字节单位
 		}arr; 
 		struct {
 			char *s;
-			size_t len;
+			lept_size len;
 		}s;
 		double n;
 	}u; //  C11 新增了匿名 struct/union 语法,可以省略u
+#ifdef LEPT_COMPACT
+	unsigned char type; // lept_type
+#else
 	lept_type type;
+#endif
+	unsigned char flags; // 内部使用的所有权标记，位于 type 之后的填充字节中，不增加结构体大小
 };
 
 struct lept_member {
 	char *k;
-	size_t klen;
+	lept_size klen;
 	lept_value v;
 };
 // 注意member与value的先后顺序
 
+#ifdef LEPT_COMPACT
+#pragma pack(pop)
+#endif
+
 #define lept_set_void(v) lept_free(v)
 
 #define lept_init(v) \
 	do { \
 		(v)->type = LEPT_VOID; \
+		(v)->flags = 0; \
 } while(0)
 
+/* 内存分配器：库中的每一次分配都经过它，ctx 原样传给三个函数。
+ * 与 C 库一样，realloc_fn(ctx, NULL, size) 须等价于 malloc_fn，free_fn(ctx, NULL) 须什么都不做。
+ * 解析、校验、查询和 stringify 中分配失败时释放已分配的部分并返回 LEPT_PARSE_OUT_OF_MEMORY；
+ * 没有错误码可返回的函数（lept_*_create()、lept_set_string()、lept_parse_ndjson() 等）仍然断言分配成功 */
+typedef struct {
+	void *(*malloc_fn)(void *ctx, size_t size);
+	void *(*realloc_fn)(void *ctx, void *ptr, size_t size);
+	void (*free_fn)(void *ctx, void *ptr);
+	void *ctx;
+}lept_allocator;
+
+/* 分配器（arena）：解析出的节点、键和字符串都从大块内存中顺序分配，整棵树一次性释放或重置 */
+typedef struct lept_arena_chunk lept_arena_chunk;
+
+typedef struct {
+	lept_arena_chunk *head, *cur;
+	size_t chunk_size;
+}lept_arena;
+
+#ifndef LEPT_ARENA_CHUNK_SIZE
+#define LEPT_ARENA_CHUNK_SIZE (64 * 1024)
+#endif
+
+/* lept_parse_options.flags */
+#define LEPT_PARSE_FLAG_INSITU 0x01        // 同 lept_parse_insitu()
+#define LEPT_PARSE_FLAG_INDEX_OBJECTS 0x02 // 解析时就为大对象建立键的散列索引，而不是等到第一次查找
+#define LEPT_PARSE_FLAG_LAZY 0x04          // 同 lept_parse_lazy()：嵌套的数组、对象和字符串第一次访问时才解码，沿用这次解析的选项。
+                                           // 注意：不加 LEPT_PARSE_FLAG_VALIDATE 时子树的语法错误要到解码时才发现，
+                                           // 访问函数这时返回 NULL、0 或 LEPT_KEY_NOT_EXIST，用 lept_lazy_decode() 取得错误码
+#define LEPT_PARSE_FLAG_VALIDATE 0x08      // 与 LEPT_PARSE_FLAG_LAZY 一起使用：暂不解码的子树也完整校验语法
+#define LEPT_PARSE_FLAG_VALIDATE_UTF8 0x10 // 字符串的原文必须是合法的 UTF-8（RFC 3629：无过长编码、无代理项、不超过 U+10FFFF）
+
+/* 一次 parse / stringify 的性能计数。只有编译 leptjson.c 时定义了 LEPT_STATS 才会填写，
+ * 否则相关代码都不会编译进来，传入的结构也不会被修改 */
+typedef struct {
+	size_t bytes;              // 解析消耗的输入字节数 / stringify 输出的字节数
+	size_t values[LEPT_VOID];  // 各类型值的个数，以 lept_type 为下标
+	size_t mallocs, reallocs;  // malloc()/realloc() 次数，不含 arena 内部的分配
+	size_t stack_grows;        // 临时栈（lept_context_push）扩容次数
+	size_t stack_peak;         // 临时栈的最大用量（字节），可据此设定 LEPT_PARSE_STACK_INIT_SIZE
+	size_t max_depth;          // 数组 / 对象的最大嵌套层数
+	uint64_t string_ns, number_ns, structural_ns; // 耗时：字符串和键、数字、其余（结构字符、空白、字面量）
+}lept_stats;
+
+/* 键的驻留表：相同的键只保存一份，可以在多个文档、多个线程之间共享 */
+typedef struct lept_symtab lept_symtab;
+
+typedef struct {
+	unsigned flags;
+	lept_arena *arena; // 非 NULL 时同 lept_parse_arena()
+	lept_symtab *symtab; // 非 NULL 时所有键都驻留到表中，成员的 k 指向表里的规范副本；表须比树活得久
+	size_t max_depth; // 数组 / 对象最多嵌套的层数，超过时返回 LEPT_PARSE_DEPTH_EXCEEDED；0 表示不限制
+	lept_stats *stats; // 非 NULL 时返回前填入这次解析的性能计数
+	const lept_allocator *allocator; // 非 NULL 时这次解析的分配都经过它，得到的树须用 lept_free_ex() 以同一个分配器释放。
+	                                 // 树中不保存这个指针，结构本身不必比树活得久；因此大对象只有同时指定
+	                                 // LEPT_PARSE_FLAG_INDEX_OBJECTS 才有散列索引，否则查找时线性比较
+	size_t *offset; // 非 NULL 时写入解析停下的位置：成功时为输入长度，LEPT_PARSE_INVALID_UTF8 时为第一个不合法的字节，其他错误时在出错的值附近
+}lept_parse_options;
+
+typedef struct {
+	lept_stats *stats; // 同 lept_parse_options.stats
+	const lept_allocator *allocator; // 非 NULL 时输出从它分配，调用者用它的 free_fn 释放
+}lept_stringify_options;
+
+#define LEPT_KEY_NOT_EXIST ((size_t)-1)
+
+/* SAX 回调：返回非 0 继续，返回 0 中止解析（lept_parse_sax 返回 LEPT_PARSE_SAX_ABORTED）。
+ * 不关心的事件置 NULL。s 不以 '\0' 结尾，只在回调期间有效 */
+typedef struct {
+	int (*null)(void *ctx);
+	int (*boolean)(void *ctx, int b);
+	int (*number)(void *ctx, double n);
+	int (*string)(void *ctx, const char *s, size_t len);
+	int (*key)(void *ctx, const char *s, size_t len);
+	int (*start_object)(void *ctx);
+	int (*end_object)(void *ctx, size_t size);
+	int (*start_array)(void *ctx);
+	int (*end_array)(void *ctx, size_t size);
+}lept_sax_handler;
+
+/* NDJSON 中的一条记录：json[offset, offset + length) 解析得到的值（error 为 LEPT_PARSE_OK 时）或错误码 */
+typedef struct {
+	lept_value v;
+	int error;
+	size_t offset, length;
+}lept_ndjson_record;
+
+/* stringify 的输出目标：成功返回 0，失败返回非 0 */
+typedef int (*lept_write_fn)(void *ctx, const char *buf, size_t len);
+
+/* 编译好的路径查询，见 lept_query_compile() */
+typedef struct lept_query lept_query;
+
+/* 查询命中一个值：raw[0, len) 是它在输入中的原文。标量（null、true、false、数字、字符串）同时解码到 v，
+ * 字符串只在回调期间有效；数组和对象的 v 为 NULL，需要时可以用 lept_parse_n()/lept_parse_lazy() 解析 raw。
+ * 返回非 0 继续，返回 0 中止查询（lept_query_run 返回 LEPT_PARSE_SAX_ABORTED） */
+typedef int (*lept_query_fn)(void *ctx, const lept_value *v, const char *raw, size_t len);
+
+/* 增量解析器：输入可以分成任意大小的块依次喂入，在字符串、数字、转义中间断开都可以 */
+typedef struct lept_parser lept_parser;
+
+/* 可复用的输出缓冲区：稳态下 stringify 不再分配内存 */
+typedef struct lept_writer lept_writer;
+
 int lept_get_type(const lept_value *);
 int lept_parse(lept_value *, char *);
+int lept_parse_arena(lept_value *, char *, lept_arena *);
+int lept_parse_insitu(lept_value *, char *);
+int lept_parse_ex(lept_value *, char *, const lept_parse_options *);
+int lept_parse_n(lept_value *, const char *, size_t len);
+int lept_parse_lazy(lept_value *, const char *, size_t len, unsigned flags);
+int lept_lazy_decode(const lept_value *);
+int lept_validate(const char *, size_t len, unsigned flags, size_t *offset);
+int lept_parse_file(lept_value *, const char *path);
+size_t lept_parse_ndjson(const char *, size_t len, unsigned threads, lept_ndjson_record **);
+void lept_ndjson_free(lept_ndjson_record *, size_t count);
+int lept_parse_parallel(lept_value *, const char *, size_t len, unsigned threads);
+int lept_parse_sax(const char *, const lept_sax_handler *, void *ctx);
+int lept_parse_sax_n(const char *, size_t len, const lept_sax_handler *, void *ctx);
+int lept_parse_sax_ex(const char *, size_t len, const lept_sax_handler *, void *ctx, const lept_parse_options *);
+lept_query *lept_query_compile(const char *path);
+void lept_query_free(lept_query *);
+int lept_query_run(const lept_query *, const char *, size_t len, lept_query_fn, void *ctx);
+lept_parser *lept_parser_create(void);
+void lept_parser_destroy(lept_parser *);
+int lept_parse_feed(lept_parser *, const char *, size_t len);
+int lept_parse_finish(lept_parser *, lept_value *);
+int lept_parser_parse(lept_parser *, lept_value *, const char *, size_t len, const lept_parse_options *);
+void lept_parser_set_retain(lept_parser *, size_t bytes);
+void lept_parser_trim(lept_parser *);
+lept_symtab *lept_symtab_create(void);
+void lept_symtab_destroy(lept_symtab *);
+const char *lept_symtab_intern(lept_symtab *, const char *key, size_t len);
+const char *lept_symtab_find(lept_symtab *, const char *key, size_t len);
+void lept_arena_init(lept_arena *, size_t chunk_size);
+void lept_arena_reset(lept_arena *);
+void lept_arena_free(lept_arena *);
 double lept_get_number(const lept_value *);
 void lept_set_string(lept_value *v, const char *, size_t);
 void lept_free(lept_value *);
+void lept_free_ex(lept_value *, const lept_allocator *);
+void lept_set_allocator(const lept_allocator *);
 void lept_set_boolean(lept_value *, int);
 int lept_get_boolean(const lept_value *);
 void lept_set_double(lept_value *, double);
@@ -79,8 +245,20 @@ const char *lept_get_object_key(const lept_value *, size_t);
 size_t letp_get_objext_len(const lept_value *, size_t);
 lept_value *lept_get_objext_value(const lept_value *, size_t);
 const char *lept_get_object_key(const lept_value *, const size_t);
-const size_t lept_get_object_key_len(const lept_value *, const size_t);
+size_t lept_get_object_key_len(const lept_value *, const size_t);
 const lept_value *lept_get_object_value(const lept_value *, const size_t);
+size_t lept_find_object_index(const lept_value *, const char *key, size_t klen);
+lept_value *lept_find_object_value(lept_value *, const char *key, size_t klen);
+size_t lept_find_object_symbol(const lept_value *, const char *sym);
 int lept_stringify(const lept_value *,char **, size_t *length);
+int lept_stringify_ex(const lept_value *, char **, size_t *length, const lept_stringify_options *);
+lept_writer *lept_writer_create(void);
+void lept_writer_destroy(lept_writer *);
+int lept_writer_write(lept_writer *, const lept_value *, const char **, size_t *length);
+void lept_writer_set_retain(lept_writer *, size_t bytes);
+void lept_writer_trim(lept_writer *);
+int lept_stringify_to_sink(const lept_value *, lept_write_fn, void *ctx, size_t buf_size);
+int lept_file_sink(void *fp, const char *, size_t);
+int lept_fd_sink(void *pfd, const char *, size_t);
 
 #endif
\ No newline at end of file
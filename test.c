@@ -1,4 +1,6 @@
-﻿#define _WINDOWS
+﻿#if defined(_MSC_VER) && !defined(_WINDOWS)
+#define _WINDOWS
+#endif
 #ifdef _WINDOWS
 #define _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
@@ -38,8 +40,10 @@ static void test_parse_object();
 static void test_stringify();
 static void test_stringify_number();
 static void test_stringify_string();
+static void test_stringify_escape();
 static void test_stringify_array();
 static void test_stringify_object();
+static void test_stringify_sink();
 static void test_parse_miss_quotation_mark();
 static void test_parse_invalid_string_escape();
 static void test_parse_invalid_string_char();
@@ -47,6 +51,27 @@ static void test_parse_invalid_unicode_hex();
 static void test_parse_invalid_unicode_hex();
 static void test_parse_invalid_unicode_surrogate();
 static void test_parse_miss_comma_or_square_bracket();
+static void test_parse_arena();
+static void test_parse_long_string();
+static void test_parse_insitu();
+static void test_find_object_value();
+static void test_parse_sax();
+static void test_parse_feed();
+static void test_reuse();
+static void test_parse_lazy();
+static void test_query();
+static void test_validate();
+static void test_parse_utf8();
+static void test_parse_n();
+static void test_parse_ndjson();
+static void test_parse_parallel();
+static void test_value_layout();
+static void test_inline_string();
+static void test_symtab();
+static void test_parse_depth();
+static void test_stats();
+static void test_allocator();
+static void test_allocator_failure();
 
 //  !!attention: there must no whitespace between BASE and (
 //  在define定义的\ 后不能添加//注释符 且 \ 后面不能有多余空格
@@ -126,13 +151,13 @@ static void test_parse_array() {
 	lept_init(&v);
 	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[ ]"));
 	EXPECT_EQ_INT(LEPT_ARRAY, lept_get_type(&v)); 
-	EXPECT_EQ_INT(0, lept_get_array_size(&v));
+	EXPECT_EQ_SIZE_T(0, lept_get_array_size(&v));
 	lept_free(&v);
 
 	lept_init(&v);
 	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[null , false , true , 123 , \"abc\"]"));
 	EXPECT_EQ_INT(LEPT_ARRAY, lept_get_type(&v));
-	EXPECT_EQ_INT(5, lept_get_array_size(&v));
+	EXPECT_EQ_SIZE_T(5, lept_get_array_size(&v));
 	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(lept_get_array_element(&v, 0)));
 	EXPECT_EQ_INT(LEPT_FALSE, lept_get_type(lept_get_array_element(&v, 1)));
 	EXPECT_EQ_INT(LEPT_TRUE, lept_get_type(lept_get_array_element(&v, 2)));
@@ -249,11 +274,25 @@ static void test_parse_number() {
 	/* Max double */
 	EXPECT_TEST_NUMBER(1.7976931348623157e+308, "1.7976931348623157e+308");
 	EXPECT_TEST_NUMBER(-1.7976931348623157e+308, "-1.7976931348623157e+308");
+	/* correct rounding beyond the fast paths */
+	EXPECT_TEST_NUMBER(0.1, "0.1");
+	EXPECT_TEST_NUMBER(1e23, "1e23");
+	EXPECT_TEST_NUMBER(9007199254740992.0, "9007199254740993"); /* halfway, ties to even */
+	EXPECT_TEST_NUMBER(9007199254740994.0, "9007199254740993.0000000000000001");
+	EXPECT_TEST_NUMBER(1.2345678901234568e29, "123456789012345678901234567890");
+	EXPECT_TEST_NUMBER(1.0, "1.00000000000000011102230246251565404236316680908203125");
+	EXPECT_TEST_NUMBER(1.0000000000000002, "1.00000000000000011102230246251565404236316680908203126");
+	EXPECT_TEST_NUMBER(2.2250738585072009e-308, "2.2250738585072011e-308");
+	EXPECT_TEST_NUMBER(4.9406564584124654e-324, "2.4703282292062328e-324");
+	EXPECT_TEST_NUMBER(0.0, "2.4703282292062327e-324");
+	EXPECT_TEST_NUMBER(1.7976931348623157e+308, "1.7976931348623158e+308");
+	EXPECT_TEST_NUMBER(3.141592653589793, "3.14159265358979323846264338327950288");
 }
 
 static void test_parse_number_too_big() {
 	EXPECT_TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "1e309", LEPT_VOID);
 	EXPECT_TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "-1e309", LEPT_VOID);
+	EXPECT_TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "1.7976931348623159e308", LEPT_VOID);
 }
 
 static void test_parse() {
@@ -287,6 +326,27 @@ static void test_parse() {
 	test_parse_invalid_unicode_hex();
 	test_parse_invalid_unicode_surrogate();
 	test_parse_miss_comma_or_square_bracket();
+	test_parse_arena();
+	test_parse_long_string();
+	test_parse_insitu();
+	test_find_object_value();
+	test_parse_sax();
+	test_parse_feed();
+	test_parse_n();
+	test_parse_ndjson();
+	test_parse_parallel();
+	test_value_layout();
+	test_inline_string();
+	test_symtab();
+	test_parse_depth();
+	test_stats();
+	test_allocator();
+	test_allocator_failure();
+	test_reuse();
+	test_parse_lazy();
+	test_query();
+	test_validate();
+	test_parse_utf8();
 }
 
 static void test_access_null() {
@@ -332,6 +392,8 @@ static void test_access_string() {
 	lept_init(&v);
 	lept_set_string(&v, "", 0);
 	EXPECT_EQ_STRING("", lept_get_string(&v), lept_get_len(&v));
+	lept_set_string(&v, NULL, 0);
+	EXPECT_EQ_STRING("", lept_get_string(&v), lept_get_len(&v));
 	lept_set_string(&v, "Hello", 5);
 	EXPECT_EQ_STRING("Hello", lept_get_string(&v), lept_get_len(&v));
 	lept_free(&v);
@@ -435,11 +497,11 @@ static void test_parse_object() {
 	}
 	EXPECT_EQ_STRING("o", lept_get_object_key(&v, 6), lept_get_object_key_len(&v, 6));
 	{
-		lept_value* o = lept_get_object_value(&v, 6);
+		const lept_value* o = lept_get_object_value(&v, 6);
 		EXPECT_EQ_INT(LEPT_OBJECT, lept_get_type(o));
 		for (i = 0; i < 3; i++) {
-			lept_value* ov = lept_get_object_value(o, i);
-			EXPECT_TRUE('1' + i == lept_get_object_key(o, i)[0]);
+			const lept_value* ov = lept_get_object_value(o, i);
+			EXPECT_TRUE((char)('1' + i) == lept_get_object_key(o, i)[0]);
 			EXPECT_EQ_SIZE_T(1, lept_get_object_key_len(o, i));
 			EXPECT_EQ_INT(LEPT_NUMBER, lept_get_type(ov));
 			EXPECT_EQ_DOUBLE(i + 1.0, lept_get_number(ov));
@@ -461,14 +523,28 @@ static void test_stringify_number() {
 	TEST_ROUNDTRIP("1.234e-20");
 
 	TEST_ROUNDTRIP("1.0000000000000002"); /* the smallest number > 1 */
-	TEST_ROUNDTRIP("4.9406564584124654e-324"); /* minimum denormal */
-	TEST_ROUNDTRIP("-4.9406564584124654e-324");
-	TEST_ROUNDTRIP("2.2250738585072009e-308");  /* Max subnormal double */
-	TEST_ROUNDTRIP("-2.2250738585072009e-308");
+	TEST_ROUNDTRIP("5e-324"); /* minimum denormal */
+	TEST_ROUNDTRIP("-5e-324");
+	TEST_ROUNDTRIP("2.225073858507201e-308");  /* Max subnormal double */
+	TEST_ROUNDTRIP("-2.225073858507201e-308");
 	TEST_ROUNDTRIP("2.2250738585072014e-308");  /* Min normal positive double */
 	TEST_ROUNDTRIP("-2.2250738585072014e-308");
 	TEST_ROUNDTRIP("1.7976931348623157e+308");  /* Max double */
 	TEST_ROUNDTRIP("-1.7976931348623157e+308");
+
+	/* shortest digits, same fixed/exponent switch as "%.17g" */
+	TEST_ROUNDTRIP("0.1");
+	TEST_ROUNDTRIP("0.3");
+	TEST_ROUNDTRIP("0.0001");
+	TEST_ROUNDTRIP("1e-05");
+	TEST_ROUNDTRIP("123.456");
+	TEST_ROUNDTRIP("9007199254740.992");
+	TEST_ROUNDTRIP("12345678901234568");
+	TEST_ROUNDTRIP("1e+17");
+	TEST_ROUNDTRIP("1.2345678901234568e+29");
+	TEST_ROUNDTRIP("5e-310");
+	TEST_ROUNDTRIP("1e+23");
+	TEST_ROUNDTRIP("[0.5,-2,1.1,100,-0.001]");
 }
 
 static void test_stringify_string() {
@@ -487,6 +563,8 @@ static void test_stringify_string() {
 	TEST_ROUNDTRIP("\"Hello\\nWorld\"");
 	TEST_ROUNDTRIP("\"\\\" \\\\ / \\b \\f \\n \\r \\t\"");
 	TEST_ROUNDTRIP("\"Hello\\u0000World\"");
+	TEST_ROUNDTRIP("\"\\u0001\\u001F\x7F\xC3\xA9\"");
+	test_stringify_escape();
 }
 
 static void test_stringify_array() {
@@ -496,6 +574,7 @@ static void test_stringify_array() {
 
 static void test_stringify_object() {
 	TEST_ROUNDTRIP("{}");
+	TEST_ROUNDTRIP("{\"a\\\"b\\n\\u0001\":1,\"\\\\\":{\"\\t\":2}}");
 	TEST_ROUNDTRIP("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
 }
 
@@ -507,6 +586,7 @@ static void test_stringify() {
 	test_stringify_string();
 	test_stringify_array();
 	test_stringify_object();
+	test_stringify_sink();
 }
 
 static void test_parse_miss_quotation_mark() {
@@ -545,12 +625,1574 @@ static void test_parse_miss_comma_or_square_bracket() {
 	EXPECT_TEST_ERROR(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, "[[]", LEPT_VOID);
 }
 
+static void test_parse_arena() {
+	lept_arena a;
+	lept_value v;
+	size_t i;
+	lept_arena_init(&a, 64);
+	for (i = 0; i < 3; i++) {
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&v, "{\"a\":[1,\"abc\",{\"long key for a second chunk\":null}],\"s\":\"Hello\\nWorld\"}", &a));
+		EXPECT_EQ_INT(LEPT_OBJECT, lept_get_type(&v));
+		EXPECT_EQ_SIZE_T(2, lept_get_object_size(&v));
+		EXPECT_EQ_STRING("a", lept_get_object_key(&v, 0), lept_get_object_key_len(&v, 0));
+		EXPECT_EQ_SIZE_T(3, lept_get_array_size(lept_get_object_value(&v, 0)));
+		EXPECT_EQ_STRING("abc", lept_get_string(lept_get_array_element(lept_get_object_value(&v, 0), 1)), lept_get_len(lept_get_array_element(lept_get_object_value(&v, 0), 1)));
+		EXPECT_EQ_STRING("long key for a second chunk", lept_get_object_key(lept_get_array_element(lept_get_object_value(&v, 0), 2), 0), lept_get_object_key_len(lept_get_array_element(lept_get_object_value(&v, 0), 2), 0));
+		EXPECT_EQ_STRING("Hello\nWorld", lept_get_string(lept_get_object_value(&v, 1)), lept_get_len(lept_get_object_value(&v, 1)));
+		lept_free(&v);
+		EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+		lept_arena_reset(&a);
+	}
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_arena(&v, "[\"abc\",[1}", &a));
+	EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+	lept_arena_free(&a);
+}
+
+/* 让引号、转义、控制字符和空白落在向量扫描的各个偏移和块边界上 */
+static void test_parse_long_string() {
+	char json[256], expect[128];
+	size_t i, n;
+	lept_value v;
+	for (n = 0; n < 100; n++) {
+		for (i = 0; i < n; i++)
+			expect[i] = (char)('a' + i % 26);
+		json[0] = '"';
+		memcpy(json + 1, expect, n);
+		json[n + 1] = '"';
+		json[n + 2] = '\0';
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+		EXPECT_EQ_SIZE_T(n, lept_get_len(&v));
+		EXPECT_TRUE(memcmp(expect, lept_get_string(&v), n) == 0);
+		lept_free(&v);
+
+		json[n + 1] = '\0';
+		EXPECT_TEST_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK, json, LEPT_VOID);
+		json[n + 1] = '\x01';
+		json[n + 2] = '"';
+		json[n + 3] = '\0';
+		EXPECT_TEST_ERROR(LEPT_PARSE_INVALID_STRING_CHAR, json, LEPT_VOID);
+		json[n + 1] = '\\';
+		json[n + 2] = 't';
+		json[n + 3] = 'x';
+		json[n + 4] = '"';
+		json[n + 5] = '\0';
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+		EXPECT_EQ_SIZE_T(n + 2, lept_get_len(&v));
+		EXPECT_TRUE(lept_get_string(&v)[n] == '\t' && lept_get_string(&v)[n + 1] == 'x');
+		lept_free(&v);
+
+		memset(json, ' ', n);
+		memcpy(json + n, "\t\r\n[ \n 1 ,\n  2 ]\n\n", 19);
+		memset(json + n + 19, ' ', n);
+		json[2 * n + 19] = '\0';
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+		EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v));
+		lept_free(&v);
+	}
+}
+
+static void test_parse_insitu() {
+	/* 短字符串和短键内联存放，只有较长的才引用输入缓冲区 */
+	char json[] = "{\"k\\ney is not short\":[\"abc\",\"x\\u00A2\\uD834\\uDD1Ey, not short\",\"\"],\"s\":\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"}";
+	char bad[] = "[\"abc\",\"\\v\"]";
+	char bad2[] = "{\"a\":1,\"b\\u12\":2}";
+	lept_value v;
+	const lept_value *a;
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_insitu(&v, json));
+	EXPECT_EQ_SIZE_T(2, lept_get_object_size(&v));
+	EXPECT_EQ_STRING("k\ney is not short", lept_get_object_key(&v, 0), lept_get_object_key_len(&v, 0));
+	EXPECT_TRUE(lept_get_object_key(&v, 0) > json && lept_get_object_key(&v, 0) < json + sizeof(json));
+	a = lept_get_object_value(&v, 0);
+	EXPECT_EQ_SIZE_T(3, lept_get_array_size(a));
+	EXPECT_EQ_STRING("abc", lept_get_string(lept_get_array_element(a, 0)), lept_get_len(lept_get_array_element(a, 0)));
+	EXPECT_EQ_STRING("x\xC2\xA2\xF0\x9D\x84\x9Ey, not short", lept_get_string(lept_get_array_element(a, 1)), lept_get_len(lept_get_array_element(a, 1)));
+	EXPECT_TRUE(lept_get_string(lept_get_array_element(a, 1)) > json && lept_get_string(lept_get_array_element(a, 1)) < json + sizeof(json));
+	EXPECT_EQ_SIZE_T(0, lept_get_len(lept_get_array_element(a, 2)));
+	EXPECT_EQ_STRING("\"\\/\b\f\n\r\t", lept_get_string(lept_get_object_value(&v, 1)), lept_get_len(lept_get_object_value(&v, 1)));
+	EXPECT_TRUE(lept_get_string(lept_get_object_value(&v, 1))[8] == '\0');
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_ESCAPE, lept_parse_insitu(&v, bad));
+	EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_UNICODE_HEX, lept_parse_insitu(&v, bad2));
+	EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+}
+
+/* 覆盖线性查找（小对象）、首次查找时建立的索引、解析时建立的索引以及 arena 中的索引 */
+static void test_find_object_value() {
+	char json[2048], key[16];
+	size_t i, n, len;
+	int mode;
+	lept_arena a;
+	lept_parse_options opt;
+	lept_value v;
+	lept_symtab *t = lept_symtab_create();
+	lept_arena_init(&a, 256);
+	for (n = 1; n <= 100; n += 33) {
+		len = 0;
+		json[len++] = '{';
+		for (i = 0; i < n; i++)
+			len += sprintf(json + len, "%s\"k%u\":%u", i ? "," : "", (unsigned)i, (unsigned)i);
+		/* 重复的键应当返回第一个 */
+		len += sprintf(json + len, ",\"k0\":-1,\"\":-2}");
+		for (mode = 0; mode < 4; mode++) {
+			opt.flags = mode == 1 ? LEPT_PARSE_FLAG_INDEX_OBJECTS : 0;
+			opt.arena = mode == 2 ? &a : NULL;
+			opt.symtab = mode == 3 ? t : NULL;
+			opt.max_depth = 0;
+			opt.stats = NULL;
+			opt.allocator = NULL;
+			opt.offset = NULL;
+			lept_init(&v);
+			EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, json, &opt));
+			for (i = 0; i < n; i++) {
+				sprintf(key, "k%u", (unsigned)i);
+				EXPECT_EQ_SIZE_T(i, lept_find_object_index(&v, key, strlen(key)));
+				EXPECT_TRUE(lept_find_object_value(&v, key, strlen(key)) != NULL);
+				EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_find_object_value(&v, key, strlen(key))));
+				if (mode == 3)
+					EXPECT_EQ_SIZE_T(i, lept_find_object_symbol(&v, lept_symtab_find(t, key, strlen(key))));
+			}
+			EXPECT_EQ_DOUBLE(-2.0, lept_get_number(lept_find_object_value(&v, "", 0)));
+			EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "k", 1));
+			EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "k00", 3));
+			EXPECT_TRUE(lept_find_object_value(&v, "missing", 7) == NULL);
+			lept_free(&v);
+			lept_arena_reset(&a);
+		}
+	}
+	/* 没有用这个表解析的文档只按指针比较，不会匹配 */
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "{\"k0\":1}"));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_symbol(&v, lept_symtab_find(t, "k0", 2)));
+	lept_free(&v);
+	lept_symtab_destroy(t);
+	lept_arena_free(&a);
+}
+
+/* 同一个表解析出的文档共享键的副本 */
+static void test_symtab() {
+	lept_symtab *t = lept_symtab_create();
+	lept_parse_options opt;
+	lept_value v1, v2;
+	char key[16], *json;
+	const char *k;
+	size_t i, len;
+	k = lept_symtab_intern(t, "id", 2);
+	EXPECT_TRUE(k == lept_symtab_intern(t, "id", 2));
+	EXPECT_TRUE(k == lept_symtab_find(t, "id", 2));
+	EXPECT_TRUE(lept_symtab_find(t, "i", 1) == NULL);
+	EXPECT_TRUE(lept_symtab_find(t, "idx", 3) == NULL);
+	EXPECT_EQ_STRING("", lept_symtab_intern(t, "", 0), 0);
+	/* 超过初始容量后已有的副本地址不变 */
+	for (i = 0; i < 1000; i++) {
+		sprintf(key, "key%u", (unsigned)i);
+		lept_symtab_intern(t, key, strlen(key));
+	}
+	EXPECT_TRUE(k == lept_symtab_find(t, "id", 2));
+	EXPECT_EQ_STRING("key999", lept_symtab_find(t, "key999", 6), strlen(lept_symtab_find(t, "key999", 6)));
+
+	opt.flags = 0;
+	opt.arena = NULL;
+	opt.symtab = t;
+	opt.max_depth = 0;
+	opt.stats = NULL;
+	opt.allocator = NULL;
+	opt.offset = NULL;
+	lept_init(&v1);
+	lept_init(&v2);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v1, "{\"id\":1,\"name\":\"a\",\"a longer key name\":[{\"id\":2}]}", &opt));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v2, "{\"name\":\"b\",\"id\":3}", &opt));
+	EXPECT_TRUE(lept_get_object_key(&v1, 0) == k);
+	EXPECT_TRUE(lept_get_object_key(&v2, 1) == k);
+	EXPECT_TRUE(lept_get_object_key(&v1, 1) == lept_get_object_key(&v2, 0));
+	EXPECT_TRUE(lept_get_object_key(lept_get_array_element(lept_get_object_value(&v1, 2), 0), 0) == k);
+	EXPECT_EQ_SIZE_T(17, lept_get_object_key_len(&v1, 2));
+	EXPECT_EQ_SIZE_T(1, lept_find_object_symbol(&v2, k));
+	EXPECT_EQ_SIZE_T(2, lept_find_object_symbol(&v1, lept_symtab_find(t, "a longer key name", 17)));
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v1, &json, &len));
+	EXPECT_EQ_STRING("{\"id\":1,\"name\":\"a\",\"a longer key name\":[{\"id\":2}]}", json, len);
+	free(json);
+	lept_free(&v1);
+	lept_free(&v2);
+	lept_symtab_destroy(t);
+}
+
+static int sax_count_end(void *ctx, size_t size) {
+	(void)size;
+	++*(size_t *)ctx;
+	return 1;
+}
+
+static void test_parse_depth() {
+	lept_sax_handler counter = { NULL, NULL, NULL, NULL, NULL, NULL, sax_count_end, NULL, sax_count_end };
+	lept_parse_options opt;
+	lept_value v;
+	size_t ends, offset;
+	char *json, *out;
+	size_t i, n = 100000, len;
+	opt.flags = 0;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 2;
+	opt.stats = NULL;
+	opt.allocator = NULL;
+	opt.offset = NULL;
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, "[[1],{\"a\":1}]", &opt));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parse_ex(&v, "[[[1]]]", &opt));
+	EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parse_ex(&v, "{\"a\":{\"b\":{}}}", &opt));
+	EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+	opt.max_depth = 1;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, "1", &opt));
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parse_ex(&v, "[\"a\",[]]", &opt));
+
+	/* SAX 使用同样的深度限制；出错前已经闭合的容器照常触发事件 */
+	opt.max_depth = 2;
+	opt.offset = &offset;
+	ends = 0;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_sax_ex("[[1],{\"a\":1}]", 13, &counter, &ends, &opt));
+	EXPECT_EQ_SIZE_T(3, ends);
+	EXPECT_EQ_SIZE_T(13, offset);
+	ends = 0;
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parse_sax_ex("[[],[[1]]]", 10, &counter, &ends, &opt));
+	EXPECT_EQ_SIZE_T(1, ends);
+	EXPECT_EQ_SIZE_T(5, offset);
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parse_sax_ex("{\"a\":{\"b\":{}}}", 14, &counter, &ends, &opt));
+	opt.offset = NULL;
+
+	/* 深度远超 C 栈能承受的递归层数，解析、生成与释放都不能爆栈 */
+	json = (char *)malloc(6 * n);
+	for (i = 0; i < n - 1; i++) {
+		memcpy(json + 5 * i, "{\"a\":", 5);
+		json[5 * n - 3 + i] = '}';
+	}
+	memcpy(json + 5 * (n - 1), "{}", 2);
+	json[6 * n - 4] = '\0';
+	ends = 0;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_sax(json, &counter, &ends));
+	EXPECT_EQ_SIZE_T(n, ends);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &out, &len));
+	EXPECT_EQ_SIZE_T(6 * n - 4, len);
+	EXPECT_TRUE(memcmp(json, out, len) == 0);
+	free(out);
+	lept_free(&v);
+	memset(json, '[', n);
+	memset(json + n, ']', n);
+	json[2 * n] = '\0';
+	ends = 0;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_sax(json, &counter, &ends));
+	EXPECT_EQ_SIZE_T(n, ends);
+	opt.max_depth = n - 1;
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parse_sax_ex(json, 2 * n, &counter, &ends, &opt));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &out, &len));
+	EXPECT_EQ_SIZE_T(2 * n, len);
+	EXPECT_TRUE(memcmp(json, out, len) == 0);
+	free(out);
+	lept_free(&v);
+	free(json);
+}
+
+static void test_stats() {
+	char json[] = " [1, \"a\", {\"k\": [true, null]}, 2.5] ", *out;
+	lept_parse_options opt;
+	lept_stringify_options sopt;
+	lept_stats s;
+	lept_value v;
+	size_t len;
+	opt.flags = 0;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 0;
+	opt.stats = &s;
+	opt.allocator = NULL;
+	opt.offset = NULL;
+	memset(&s, 0, sizeof(s));
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, json, &opt));
+#ifdef LEPT_STATS
+	EXPECT_EQ_SIZE_T(strlen(json), s.bytes);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_NULL]);
+	EXPECT_EQ_SIZE_T(0, s.values[LEPT_FALSE]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_TRUE]);
+	EXPECT_EQ_SIZE_T(2, s.values[LEPT_NUMBER]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_STRING]);
+	EXPECT_EQ_SIZE_T(2, s.values[LEPT_ARRAY]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_OBJECT]);
+	EXPECT_EQ_SIZE_T(3, s.max_depth);
+	/* 三个元素 / 成员块；短字符串和键都内联在节点中 */
+	EXPECT_EQ_SIZE_T(3, s.mallocs);
+	EXPECT_TRUE(s.stack_grows >= 1 && s.stack_peak > 0);
+#else
+	EXPECT_EQ_SIZE_T(0, s.bytes);
+#endif
+	sopt.stats = &s;
+	sopt.allocator = NULL;
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_ex(&v, &out, &len, &sopt));
+	EXPECT_EQ_STRING("[1,\"a\",{\"k\":[true,null]},2.5]", out, len);
+#ifdef LEPT_STATS
+	EXPECT_EQ_SIZE_T(len, s.bytes);
+	EXPECT_EQ_SIZE_T(2, s.values[LEPT_NUMBER]);
+	EXPECT_EQ_SIZE_T(2, s.values[LEPT_ARRAY]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_OBJECT]);
+	EXPECT_EQ_SIZE_T(3, s.max_depth);
+	EXPECT_EQ_SIZE_T(1, s.mallocs);
+#else
+	EXPECT_EQ_SIZE_T(0, s.bytes);
+#endif
+	free(out);
+	lept_free(&v);
+}
+
+/* 统计调用次数和尚未释放的块数；fail_at 非 0 时第 fail_at 次调用返回 NULL */
+typedef struct {
+	size_t calls, live, largest, fail_at;
+}counting_heap;
+
+static void *counting_malloc(void *ctx, size_t size) {
+	counting_heap *h = (counting_heap *)ctx;
+	if (++h->calls == h->fail_at)
+		return NULL;
+	h->live++;
+	if (size > h->largest)
+		h->largest = size;
+	return malloc(size);
+}
+
+static void *counting_realloc(void *ctx, void *p, size_t size) {
+	counting_heap *h = (counting_heap *)ctx;
+	if (++h->calls == h->fail_at)
+		return NULL;
+	if (p == NULL)
+		h->live++;
+	if (size > h->largest)
+		h->largest = size;
+	return realloc(p, size);
+}
+
+static void counting_free(void *ctx, void *p) {
+	counting_heap *h = (counting_heap *)ctx;
+	if (p != NULL)
+		h->live--;
+	free(p);
+}
+
+/* 在向量内核整块与尾部的每个位置放一个需要转义的字节，输出须与逐字节转义一致；
+ * 不需要转义的长字符串只按实际长度预留栈空间 */
+static void test_stringify_escape() {
+	static const char specials[] = { '\"', '\\', '\n', '\x01', '\x1F' };
+	static const char *escaped[] = { "\\\"", "\\\\", "\\n", "\\u0001", "\\u001F" };
+	counting_heap heap = { 0, 0, 0, 0 };
+	lept_stringify_options sopt;
+	lept_allocator a;
+	lept_value v;
+	char s[100], expect[120], *json, *p;
+	size_t i, j, len;
+	memset(s, 'x', sizeof(s));
+	lept_init(&v);
+	for (i = 0; i < sizeof(s); i++)
+		for (j = 0; j < sizeof(specials); j++) {
+			s[i] = specials[j];
+			lept_set_string(&v, s, sizeof(s));
+			p = expect;
+			*p++ = '\"';
+			memset(p, 'x', i);
+			p += i;
+			p += sprintf(p, "%s", escaped[j]);
+			memset(p, 'x', sizeof(s) - i - 1);
+			p += sizeof(s) - i - 1;
+			*p++ = '\"';
+			EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &json, &len));
+			EXPECT_EQ_SIZE_T((size_t)(p - expect), len);
+			EXPECT_TRUE(len == (size_t)(p - expect) && memcmp(expect, json, len) == 0);
+			free(json);
+			s[i] = 'x';
+		}
+	a.malloc_fn = counting_malloc;
+	a.realloc_fn = counting_realloc;
+	a.free_fn = counting_free;
+	a.ctx = &heap;
+	sopt.stats = NULL;
+	sopt.allocator = &a;
+	len = 100000;
+	p = (char *)malloc(len);
+	memset(p, 'x', len);
+	lept_set_string(&v, p, len);
+	free(p);
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_ex(&v, &json, &len, &sopt));
+	EXPECT_EQ_SIZE_T(100002, len);
+	EXPECT_TRUE(heap.largest < 2 * len);
+	a.free_fn(a.ctx, json);
+	lept_free(&v);
+}
+
+/* 分配器结构只在这次调用中有效，树不能保存它的地址 */
+static int parse_with_scoped_allocator(lept_value *v, char *json, counting_heap *heap, unsigned flags) {
+	lept_allocator a;
+	lept_parse_options opt;
+	a.malloc_fn = counting_malloc;
+	a.realloc_fn = counting_realloc;
+	a.free_fn = counting_free;
+	a.ctx = heap;
+	opt.flags = flags;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 0;
+	opt.stats = NULL;
+	opt.allocator = &a;
+	opt.offset = NULL;
+	return lept_parse_ex(v, json, &opt);
+}
+
+static void test_allocator() {
+	counting_heap heap = { 0, 0, 0, 0 };
+	lept_allocator a;
+	lept_parse_options opt;
+	lept_stringify_options sopt;
+	lept_value v;
+	char json[2048], *out;
+	size_t i, n, len;
+	a.malloc_fn = counting_malloc;
+	a.realloc_fn = counting_realloc;
+	a.free_fn = counting_free;
+	a.ctx = &heap;
+	/* 足够大的对象带有索引槽位；用单独的分配器解析时，只有指定 LEPT_PARSE_FLAG_INDEX_OBJECTS 才建立索引 */
+	n = sprintf(json, "{");
+	for (i = 0; i < 20; i++)
+		n += sprintf(json + n, "%s\"a rather long key %u\":[\"a rather long string value\",%u]", i == 0 ? "" : ",", (unsigned)i, (unsigned)i);
+	sprintf(json + n, "}");
+	opt.flags = 0;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 0;
+	opt.stats = NULL;
+	opt.allocator = &a;
+	opt.offset = NULL;
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, json, &opt));
+	EXPECT_TRUE(heap.calls > 0 && heap.live > 0);
+	n = heap.calls;
+	EXPECT_EQ_SIZE_T(7, lept_find_object_index(&v, "a rather long key 7", 19));
+	EXPECT_EQ_SIZE_T(n, heap.calls);
+	sopt.stats = NULL;
+	sopt.allocator = &a;
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_ex(&v, &out, &len, &sopt));
+	EXPECT_EQ_SIZE_T(strlen(json), len);
+	EXPECT_TRUE(memcmp(json, out, len) == 0);
+	a.free_fn(a.ctx, out);
+	lept_free_ex(&v, &a);
+	EXPECT_EQ_SIZE_T(0, heap.live);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_ex(&v, "{\"a rather long key\":[\"a rather long string value\"]]", &opt));
+	EXPECT_EQ_SIZE_T(0, heap.live);
+	/* 解析时的分配器结构已经失效，查找和释放只用 lept_free_ex() 传入的那一个 */
+	for (i = 0; i < 2; i++) {
+		EXPECT_EQ_INT(LEPT_PARSE_OK, parse_with_scoped_allocator(&v, json, &heap, i ? LEPT_PARSE_FLAG_INDEX_OBJECTS : 0));
+		n = heap.calls;
+		EXPECT_EQ_SIZE_T(19, lept_find_object_index(&v, "a rather long key 19", 20));
+		EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "a rather long key 20", 20));
+		EXPECT_EQ_SIZE_T(n, heap.calls);
+		lept_free_ex(&v, &a);
+		EXPECT_EQ_SIZE_T(0, heap.live);
+	}
+
+	/* 全局分配器 */
+	heap.calls = 0;
+	lept_set_allocator(&a);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	lept_set_string(lept_get_array_element(lept_find_object_value(&v, "a rather long key 3", 19), 0), "another long string value", 25);
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &out, &len));
+	a.free_fn(a.ctx, out);
+	lept_free(&v);
+	lept_set_allocator(NULL);
+	EXPECT_TRUE(heap.calls > 0);
+	EXPECT_EQ_SIZE_T(0, heap.live);
+}
+
+/* 依次让第 1、2、... 次分配失败，直到不再用到失败的那一次：之前每次都返回 LEPT_PARSE_OUT_OF_MEMORY，且没有泄漏 */
+static void test_allocator_failure() {
+	static char json[] = "{\"a rather long key\":[\"a rather long string value\\n\",1.5,true,null],"
+		"\"k\":[[[[[[[[[[[[[[[[[[[[\"x\",{\"another long key name\":\"y\"}]]]]]]]]]]]]]]]]]]]]}";
+	counting_heap heap = { 0, 0, 0, 0 };
+	lept_sax_handler none = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+	lept_allocator a;
+	lept_parse_options opt;
+	lept_stringify_options sopt;
+	lept_parser *p;
+	lept_value v;
+	char *out;
+	size_t i, live, len;
+	int ret;
+	a.malloc_fn = counting_malloc;
+	a.realloc_fn = counting_realloc;
+	a.free_fn = counting_free;
+	a.ctx = &heap;
+	opt.flags = 0;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 0;
+	opt.stats = NULL;
+	opt.allocator = &a;
+	opt.offset = NULL;
+	sopt.stats = NULL;
+	sopt.allocator = &a;
+	lept_init(&v);
+	for (i = 1; ; i++) {
+		heap.calls = 0;
+		heap.fail_at = i;
+		if ((ret = lept_parse_sax_ex(json, sizeof(json) - 1, &none, NULL, &opt)) == LEPT_PARSE_OK)
+			break;
+		EXPECT_EQ_INT(LEPT_PARSE_OUT_OF_MEMORY, ret);
+		EXPECT_EQ_SIZE_T(0, heap.live);
+	}
+	EXPECT_TRUE(i > 1);
+	for (i = 1; ; i++) {
+		heap.calls = 0;
+		heap.fail_at = i;
+		if ((ret = lept_parse_ex(&v, json, &opt)) == LEPT_PARSE_OK)
+			break;
+		EXPECT_EQ_INT(LEPT_PARSE_OUT_OF_MEMORY, ret);
+		EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+		EXPECT_EQ_SIZE_T(0, heap.live);
+	}
+	EXPECT_TRUE(i > 1);
+	live = heap.live;
+	for (i = 1; ; i++) {
+		heap.calls = 0;
+		heap.fail_at = i;
+		if ((ret = lept_stringify_ex(&v, &out, &len, &sopt)) == LEPT_STRINGIFY_OK)
+			break;
+		EXPECT_EQ_INT(LEPT_PARSE_OUT_OF_MEMORY, ret);
+		EXPECT_TRUE(out == NULL);
+		EXPECT_EQ_SIZE_T(live, heap.live);
+	}
+	EXPECT_TRUE(i > 1);
+	EXPECT_EQ_STRING(json, out, len);
+	a.free_fn(a.ctx, out);
+	lept_free_ex(&v, &a);
+	EXPECT_EQ_SIZE_T(0, heap.live);
+
+	/* 增量解析器只用全局分配器 */
+	heap.fail_at = 0;
+	lept_set_allocator(&a);
+	p = lept_parser_create();
+	live = heap.live;
+	for (i = 1; ; i++) {
+		heap.calls = 0;
+		heap.fail_at = i;
+		lept_parse_feed(p, json, sizeof(json) - 1);
+		if ((ret = lept_parse_finish(p, &v)) == LEPT_PARSE_OK)
+			break;
+		EXPECT_EQ_INT(LEPT_PARSE_OUT_OF_MEMORY, ret);
+		/* 保留的缓冲区之外不能有剩下的块 */
+		lept_parser_trim(p);
+		EXPECT_EQ_SIZE_T(live, heap.live);
+	}
+	EXPECT_TRUE(i > 1);
+	heap.fail_at = 0;
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &out, &len));
+	EXPECT_EQ_STRING(json, out, len);
+	a.free_fn(a.ctx, out);
+	lept_free(&v);
+	lept_parser_destroy(p);
+	lept_set_allocator(NULL);
+	EXPECT_EQ_SIZE_T(0, heap.live);
+}
+
+/* 解析 json 再写出，返回这一轮向全局分配器请求的次数 */
+static size_t reuse_round(counting_heap *heap, lept_parser *p, lept_writer *w, const char *json, const char **out) {
+	size_t calls = heap->calls, len;
+	lept_value v;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v, json, strlen(json), NULL));
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_writer_write(w, &v, out, &len));
+	EXPECT_EQ_SIZE_T(strlen(json), len);
+	EXPECT_TRUE(memcmp(json, *out, len) == 0);
+	lept_free(&v);
+	return heap->calls - calls;
+}
+
+static void test_reuse() {
+	static const char json[] = "[[1,2,3],{\"k\":[true,null,false]},[[[]]],0.5]";
+	counting_heap heap = { 0, 0, 0, 0 };
+	lept_allocator a;
+	lept_parse_options opt;
+	lept_stats s;
+	lept_parser *p;
+	lept_writer *w;
+	lept_value v;
+	const char *out, *out2;
+	size_t first, steady, n;
+	a.malloc_fn = counting_malloc;
+	a.realloc_fn = counting_realloc;
+	a.free_fn = counting_free;
+	a.ctx = &heap;
+	lept_set_allocator(&a);
+	p = lept_parser_create();
+	w = lept_writer_create();
+	first = reuse_round(&heap, p, w, json, &out);
+	steady = reuse_round(&heap, p, w, json, &out2);
+	/* 稳态下只剩数组 / 对象本身的分配，输出缓冲区原样复用 */
+	EXPECT_TRUE(steady < first);
+	EXPECT_TRUE(out == out2);
+	n = reuse_round(&heap, p, w, json, &out);
+	EXPECT_EQ_SIZE_T(steady, n);
+	EXPECT_TRUE(out == out2);
+	/* 增量解析之后也能接着整块解析 */
+	lept_parse_feed(p, json, 5);
+	n = reuse_round(&heap, p, w, json, &out);
+	EXPECT_EQ_SIZE_T(steady, n);
+
+	/* 显式 trim 之后第一轮重新分配 */
+	lept_parser_trim(p);
+	lept_writer_trim(w);
+	n = reuse_round(&heap, p, w, json, &out);
+	EXPECT_EQ_SIZE_T(first, n);
+	n = reuse_round(&heap, p, w, json, &out);
+	EXPECT_EQ_SIZE_T(steady, n);
+
+	/* 不保留：缓冲区在下一轮开始前（parser 在这一轮结束时）释放，之后每一轮都和第一轮一样 */
+	lept_parser_set_retain(p, 0);
+	lept_writer_set_retain(w, 0);
+	reuse_round(&heap, p, w, json, &out);
+	n = reuse_round(&heap, p, w, json, &out);
+	EXPECT_EQ_SIZE_T(first, n);
+	n = reuse_round(&heap, p, w, json, &out);
+	EXPECT_EQ_SIZE_T(first, n);
+	lept_parser_set_retain(p, (size_t)-1);
+	lept_writer_set_retain(w, (size_t)-1);
+
+	/* 出错也不影响后续调用 */
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parser_parse(p, &v, "[[1,2}", 6, NULL));
+	EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+	opt.flags = 0;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 2;
+	opt.stats = &s;
+	opt.allocator = NULL;
+	opt.offset = NULL;
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parser_parse(p, &v, json, strlen(json), &opt));
+	opt.max_depth = 0;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v, json, strlen(json), &opt));
+#ifdef LEPT_STATS
+	EXPECT_EQ_SIZE_T(0, s.stack_grows);
+#endif
+	lept_free(&v);
+	n = reuse_round(&heap, p, w, json, &out);
+	EXPECT_EQ_SIZE_T(steady, n);
+
+	lept_parser_destroy(p);
+	lept_writer_destroy(w);
+	lept_set_allocator(NULL);
+	EXPECT_EQ_SIZE_T(0, heap.live);
+}
+
+static void test_parse_lazy() {
+	static const char *valid[] = {
+		"null", "123.5", "\"a \\\"quoted\\\" string\"", "[ ]", "{ }",
+		"[ null , false , true , 123 , \"abc\" ]", "[ [ ] , [ 0 ] , [ 0 , 1 ] , [ 0 , [ 1 , [ 2 ] ] ] ]",
+		" { \"n\" : null , \"f\" : false , \"t\" : true , \"i\" : 123 , \"s\" : \"a]b}c\\\"\", \"a\" : [ 1, 2, 3 ],"
+		" \"o\" : { \"1\" : 1, \"2\" : [\"x\\u0024\\uD834\\uDD1E\"], \"3\" : {\"[\":\"{\"} } } "
+	};
+	/* 错误都在嵌套的子树中：校验模式与完整解析的错误码相同，不校验时只有不完整的字符串和括号会被发现 */
+	static const struct {
+		const char *json;
+		int error, lazy_error;
+	}invalid[] = {
+		{ "[[1,]]", LEPT_PARSE_INVALID_VALUE, LEPT_PARSE_OK },
+		{ "[[1 2]]", LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, LEPT_PARSE_OK },
+		{ "[[1}]", LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, LEPT_PARSE_OK },
+		{ "[[nul]]", LEPT_PARSE_INVALID_VALUE, LEPT_PARSE_OK },
+		{ "[[1e309]]", LEPT_PARSE_NUMBER_TOO_BIG, LEPT_PARSE_OK },
+		{ "[\"\\v\"]", LEPT_PARSE_INVALID_STRING_ESCAPE, LEPT_PARSE_OK },
+		{ "[\"\x01\"]", LEPT_PARSE_INVALID_STRING_CHAR, LEPT_PARSE_OK },
+		{ "[\"\\uD800\"]", LEPT_PARSE_INVALID_UNICODE_SURROGATE, LEPT_PARSE_OK },
+		{ "{\"a\":{\"b\"}}", LEPT_PARSE_MISS_COLON, LEPT_PARSE_OK },
+		{ "{\"a\":{1:1}}", LEPT_PARSE_MISS_KEY, LEPT_PARSE_OK },
+		{ "[{\"a\":1 \"b\":2}]", LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, LEPT_PARSE_OK },
+		{ "[[1]", LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET },
+		{ "[[1", LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET },
+		{ "{\"a\":{\"b\":1}", LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET },
+		{ "[\"abc]", LEPT_PARSE_MISS_QUOTATION_MARK, LEPT_PARSE_MISS_QUOTATION_MARK },
+		{ "[[\"\\\"]]", LEPT_PARSE_MISS_QUOTATION_MARK, LEPT_PARSE_MISS_QUOTATION_MARK }
+	};
+	static const char json[] = "{\"id\":7,\"tags\":[\"a\",\"a rather long tag\"],\"user\":{\"name\":\"x\\ny\",\"langs\":[[1],{}]},\"bad\":[1,2x]}";
+	counting_heap heap = { 0, 0, 0, 0 };
+	lept_allocator a;
+	lept_arena arena;
+	lept_symtab *t;
+	lept_parse_options opt;
+	lept_value v, expect;
+	const lept_value *e;
+	char *out, *out2, *deep, buf[64];
+	size_t i, len, len2, eager, lazy, calls, n = 100000;
+	for (i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+		lept_init(&expect);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&expect, (char *)valid[i]));
+		EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&expect, &out, &len));
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&v, valid[i], strlen(valid[i]), 0));
+		EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &out2, &len2));
+		EXPECT_EQ_SIZE_T(len, len2);
+		EXPECT_TRUE(memcmp(out, out2, len) == 0);
+		free(out2);
+		lept_free(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&v, valid[i], strlen(valid[i]), LEPT_PARSE_FLAG_VALIDATE));
+		lept_free(&v);
+		free(out);
+		lept_free(&expect);
+	}
+	for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+		lept_init(&v);
+		EXPECT_EQ_INT(invalid[i].error, lept_parse(&v, (char *)invalid[i].json));
+		EXPECT_EQ_INT(invalid[i].error, lept_parse_lazy(&v, invalid[i].json, strlen(invalid[i].json), LEPT_PARSE_FLAG_VALIDATE));
+		EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+		EXPECT_EQ_INT(invalid[i].lazy_error, lept_parse_lazy(&v, invalid[i].json, strlen(invalid[i].json), 0));
+		/* 解码出错的节点保持惰性，每次解码都得到同一个错误码 */
+		if (invalid[i].lazy_error == LEPT_PARSE_OK) {
+			e = lept_get_type(&v) == LEPT_ARRAY ? lept_get_array_element(&v, 0) : lept_get_object_value(&v, 0);
+			EXPECT_EQ_INT(invalid[i].error, lept_lazy_decode(e));
+			EXPECT_EQ_INT(invalid[i].error, lept_lazy_decode(e));
+			EXPECT_EQ_INT(invalid[i].error, lept_stringify(&v, &out, &len));
+		}
+		lept_free(&v);
+	}
+
+	/* 只访问少数字段时，惰性解析的分配次数少得多 */
+	a.malloc_fn = counting_malloc;
+	a.realloc_fn = counting_realloc;
+	a.free_fn = counting_free;
+	a.ctx = &heap;
+	lept_set_allocator(&a);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_n(&v, json, sizeof(json) - 1));
+	eager = heap.calls;
+	heap.calls = 0;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&v, json, sizeof(json) - 1, 0));
+	EXPECT_EQ_DOUBLE(7.0, lept_get_number(lept_find_object_value(&v, "id", 2)));
+	lazy = heap.calls;
+	EXPECT_TRUE(lazy < eager);
+	e = lept_find_object_value(&v, "user", 4);
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_get_type(e));
+	EXPECT_EQ_SIZE_T(2, lept_get_object_size(e));
+	EXPECT_EQ_STRING("x\ny", lept_get_string(lept_get_object_value(e, 0)), lept_get_len(lept_get_object_value(e, 0)));
+	e = lept_get_object_value(e, 1);
+	EXPECT_EQ_INT(LEPT_ARRAY, lept_get_type(e));
+	EXPECT_EQ_INT(LEPT_ARRAY, lept_get_type(lept_get_array_element(e, 0)));
+	EXPECT_EQ_SIZE_T(1, lept_get_array_size(lept_get_array_element(e, 0)));
+	e = lept_find_object_value(&v, "tags", 4);
+	EXPECT_EQ_STRING("a rather long tag", lept_get_string(lept_get_array_element(e, 1)), lept_get_len(lept_get_array_element(e, 1)));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_decode(e));
+	/* 没有校验的子树出错时访问函数返回 0 / NULL，节点仍是数组 */
+	e = lept_find_object_value(&v, "bad", 3);
+	EXPECT_EQ_SIZE_T(0, lept_get_array_size(e));
+	EXPECT_TRUE(lept_get_array_element(e, 0) == NULL);
+	EXPECT_EQ_INT(LEPT_ARRAY, lept_get_type(e));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_lazy_decode(e));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_lazy(&v, json, sizeof(json) - 1, LEPT_PARSE_FLAG_VALIDATE));
+	lept_set_allocator(NULL);
+	EXPECT_EQ_SIZE_T(0, heap.live);
+
+	/* 深层嵌套：校验和逐层解码都不递归，max_depth 同样适用于跳过的子树。
+	 * 每解码一层都要重新扫描其下的原文，所以只往下走前 100 层 */
+	deep = (char *)malloc(2 * n);
+	memset(deep, '[', n);
+	memset(deep + n, ']', n);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&v, deep, 2 * n, LEPT_PARSE_FLAG_VALIDATE));
+	for (e = &v, i = 0; i < 100; i++) {
+		EXPECT_EQ_SIZE_T(1, lept_get_array_size(e));
+		e = lept_get_array_element(e, 0);
+	}
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_lazy(&v, deep + n - 100, 200, 0));
+	for (e = &v, i = 1; i < 100; i++)
+		e = lept_get_array_element(e, 0);
+	EXPECT_EQ_SIZE_T(0, lept_get_array_size(e));
+	lept_free(&v);
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 2;
+	opt.stats = NULL;
+	opt.allocator = NULL;
+	opt.offset = NULL;
+	opt.flags = LEPT_PARSE_FLAG_LAZY;
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parse_ex(&v, "[[[1]]]", &opt));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, "[[1],{\"a\":1}]", &opt));
+	lept_free(&v);
+	opt.flags = LEPT_PARSE_FLAG_LAZY | LEPT_PARSE_FLAG_VALIDATE;
+	EXPECT_EQ_INT(LEPT_PARSE_DEPTH_EXCEEDED, lept_parse_ex(&v, "[{\"a\":{}}]", &opt));
+	/* 逐层解码时 max_depth 按节点所在的层数折算，不会误报 */
+	opt.max_depth = 3;
+	opt.flags = LEPT_PARSE_FLAG_LAZY;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, "[[[1]]]", &opt));
+	e = lept_get_array_element(lept_get_array_element(&v, 0), 0);
+	EXPECT_EQ_SIZE_T(1, lept_get_array_size(e));
+	EXPECT_EQ_DOUBLE(1.0, lept_get_number(lept_get_array_element(e, 0)));
+	lept_free(&v);
+	free(deep);
+
+	/* 之后的解码沿用解析时的分配器、arena、驻留表和原地解析 */
+	opt.max_depth = 0;
+	opt.allocator = &a;
+	strcpy(buf, "{\"k\":[\"a rather long string\",{\"key\":1}]}");
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, buf, &opt));
+	calls = heap.calls;
+	e = lept_get_array_element(lept_get_object_value(&v, 0), 0);
+	EXPECT_EQ_STRING("a rather long string", lept_get_string(e), lept_get_len(e));
+	EXPECT_TRUE(heap.calls > calls);
+	lept_free_ex(&v, &a);
+	EXPECT_EQ_SIZE_T(0, heap.live);
+	opt.allocator = NULL;
+	lept_arena_init(&arena, 64);
+	opt.arena = &arena;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, buf, &opt));
+	e = lept_get_array_element(lept_get_object_value(&v, 0), 1);
+	EXPECT_EQ_SIZE_T(1, lept_get_object_size(e));
+	EXPECT_EQ_DOUBLE(1.0, lept_get_number(lept_get_object_value(e, 0)));
+	lept_free(&v);
+	lept_arena_free(&arena);
+	opt.arena = NULL;
+	t = lept_symtab_create();
+	opt.symtab = t;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, buf, &opt));
+	e = lept_get_array_element(lept_get_object_value(&v, 0), 1);
+	EXPECT_EQ_SIZE_T(1, lept_get_object_size(e));
+	EXPECT_EQ_SIZE_T(0, lept_find_object_symbol(e, lept_symtab_find(t, "key", 3)));
+	lept_free(&v);
+	lept_symtab_destroy(t);
+	opt.symtab = NULL;
+	opt.flags = LEPT_PARSE_FLAG_LAZY | LEPT_PARSE_FLAG_INSITU;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, buf, &opt));
+	e = lept_get_array_element(lept_get_object_value(&v, 0), 0);
+	EXPECT_EQ_STRING("a rather long string", lept_get_string(e), lept_get_len(e));
+	EXPECT_TRUE(lept_get_string(e) > buf && lept_get_string(e) < buf + sizeof(buf));
+	lept_free(&v);
+}
+
+/* 把命中的值记录成一行：标量记类型和解码结果，容器记原文；第 abort_at 个命中（从 1 开始，0 表示不中止）返回 0 */
+typedef struct {
+	char trace[256];
+	size_t len;
+	int hits, abort_at;
+}query_recorder;
+
+static int query_record(void *ctx, const lept_value *v, const char *raw, size_t len) {
+	query_recorder *r = (query_recorder *)ctx;
+	if (v == NULL) {
+		memcpy(r->trace + r->len, raw, len);
+		r->len += len;
+	}
+	else if (lept_get_type(v) == LEPT_STRING) {
+		r->len += sprintf(r->trace + r->len, "s:%s", lept_get_string(v));
+		EXPECT_EQ_SIZE_T(strlen(lept_get_string(v)), lept_get_len(v));
+	}
+	else if (lept_get_type(v) == LEPT_NUMBER)
+		r->len += sprintf(r->trace + r->len, "%g", lept_get_number(v));
+	else
+		r->len += sprintf(r->trace + r->len, "%.*s", (int)len, raw);
+	r->trace[r->len++] = ' ';
+	r->trace[r->len] = '\0';
+	return ++r->hits != r->abort_at;
+}
+
+#define EXPECT_TEST_QUERY(error, expect, path, json, abort_hit) \
+	do { \
+		query_recorder r; \
+		lept_query *q = lept_query_compile(path); \
+		EXPECT_TRUE(q != NULL); \
+		r.len = 0; \
+		r.trace[0] = '\0'; \
+		r.hits = 0; \
+		r.abort_at = abort_hit; \
+		EXPECT_EQ_INT(error, lept_query_run(q, json, strlen(json), query_record, &r)); \
+		EXPECT_EQ_STRING(expect, r.trace, r.len); \
+		lept_query_free(q); \
+	} while(0)
+
+static void test_query() {
+	static const char json[] =
+		" { \"items\" : [ {\"price\":1.5,\"name\":\"a\"}, {\"name\":\"b]\",\"price\":2}, {\"price\":\"n\\/a\"}, {\"x\":{\"price\":9}}, 7 ],"
+		" \"meta\" : {\"a/b\":{\"m~n\":[10,20,30]}, \"flags\":[true,false,null]}, \"count\": 3 } ";
+	counting_heap heap = { 0, 0, 0, 0 };
+	lept_allocator a;
+	lept_query *q;
+	query_recorder r;
+	char deep[82], path[81];
+	size_t i;
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "1.5 2 s:n/a ", "/items/*/price", json, 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "20 ", "/meta/a~1b/m~0n/1", json, 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "{\"name\":\"b]\",\"price\":2} ", "/items/1", json, 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "true false null ", "/meta/flags/*", json, 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "3 ", "/count", json, 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "", "/nope", json, 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "", "/items/01", json, 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "", "/count/0", json, 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "9 ", "/items/*/*/price", json, 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "[1,2] ", "", "  [1,2] ", 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "s:x ", "", "\"x\"", 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_SAX_ABORTED, "1.5 2 ", "/items/*/price", json, 2);
+	/* 只检查走过的部分 */
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "1 ", "/a", "{\"a\":1,\"b\":[1,]}", 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_MISS_COLON, "", "/a/b", "{\"a\":{\"b\" 1}}", 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_MISS_KEY, "", "/a", "{1:1}", 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, "", "/*/b", "[{\"a\":1} {\"b\":2}]", 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_MISS_QUOTATION_MARK, "", "/*", "[\"abc", 0);
+	EXPECT_TEST_QUERY(LEPT_PARSE_INVALID_VALUE, "", "/a", "{\"a\":nul}", 0);
+	/* 比 LEPT_WALK_STACK_SIZE 更深的路径 */
+	memset(deep, '[', 40);
+	deep[40] = '5';
+	memset(deep + 41, ']', 40);
+	deep[81] = '\0';
+	for (i = 0; i < 40; i++)
+		memcpy(path + 2 * i, "/0", 2);
+	path[80] = '\0';
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "5 ", path, deep, 0);
+	path[78] = '\0';
+	EXPECT_TEST_QUERY(LEPT_PARSE_OK, "[5] ", path, deep, 0);
+	EXPECT_TRUE(lept_query_compile("items") == NULL);
+	EXPECT_TRUE(lept_query_compile("/a~2") == NULL);
+	EXPECT_TRUE(lept_query_compile("/a~") == NULL);
+
+	/* 不构造 DOM：只为解码键和字符串分配一次临时栈 */
+	a.malloc_fn = counting_malloc;
+	a.realloc_fn = counting_realloc;
+	a.free_fn = counting_free;
+	a.ctx = &heap;
+	q = lept_query_compile("/items/*/price");
+	lept_set_allocator(&a);
+	r.len = 0;
+	r.hits = 0;
+	r.abort_at = 0;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_query_run(q, json, sizeof(json) - 1, query_record, &r));
+	EXPECT_EQ_INT(3, r.hits);
+	EXPECT_EQ_SIZE_T(1, heap.calls);
+	EXPECT_EQ_SIZE_T(0, heap.live);
+	lept_set_allocator(NULL);
+	lept_query_free(q);
+}
+
+#define EXPECT_VALIDATE_ERROR(error, json, expect_offset) \
+	do { \
+		size_t offset; \
+		EXPECT_EQ_INT(error, lept_validate(json, sizeof(json) - 1, 0, &offset)); \
+		EXPECT_EQ_SIZE_T(expect_offset, offset); \
+	} while(0)
+
+static void test_validate() {
+	static const char *docs[] = {
+		"null", " true ", "false", "0", "-0.0", "123.456e-7", "1E+10", "-1.7976931348623157e308", "4.9406564584124654e-324",
+		"\"\"", "\"Hello\\nWorld\"", "\"\\\" \\\\ \\/ \\b \\f \\n \\r \\t\"", "\"\\u0024\\u00A2\\u20AC\\uD834\\uDD1E\\ud834\\udd1e\"",
+		"[ ]", "{ }", "[ null , false , true , 123 , \"abc\" ]", "[ [ ] , [ 0 ] , [ 0 , 1 ] , [ 0 , 1 , 2 ] ]",
+		" { \"n\" : null , \"f\" : false , \"t\" : true , \"i\" : 123 , \"s\" : \"abc\", \"a\" : [ 1, 2, 3 ],"
+		" \"o\" : { \"1\" : 1, \"2\" : 2, \"3\" : { \"[\" : [ {} ] } } } ",
+		"", " ", "nul", "?", "+0", ".123", "1.", "1e", "1e+", "-", "INF", "nan", "0123", "0x0", "1e309", "-1e309",
+		"null x", "[1,]", "[\"a\", nul]", "[1", "[1}", "[1 2", "[[]", "[{]", "{\"a\":[}",
+		"\"", "\"abc", "\"\\v\"", "\"\\", "\"\\u", "\"\\u01", "\"\\u012\"", "\"\\uDBFF\"", "\"\\uD800\\", "\"\\uD800\\u", "\"\\uD800\\uDBFF\"", "\"\x01\"",
+		"{:1,", "{1:1,", "{true:1,", "{\"a\":1,", "{\"a\"}", "{\"a\",\"b\"}", "{\"a\"", "{\"a\":", "{\"a\":1", "{\"a\":1]", "{\"a\":1 \"b\"", "{\"a\":{}"
+	};
+	counting_heap heap = { 0, 0, 0, 0 };
+	lept_allocator a;
+	lept_value v;
+	char *deep;
+	size_t i, n, offset;
+	/* 错误码与完整解析一致 */
+	for (i = 0; i < sizeof(docs) / sizeof(docs[0]); i++) {
+		n = strlen(docs[i]);
+		lept_init(&v);
+		EXPECT_EQ_INT(lept_parse_n(&v, docs[i], n), lept_validate(docs[i], n, 0, NULL));
+		lept_free(&v);
+	}
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_OK, " [1, {\"a\": \"b\"}] ", 17);
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_INVALID_STRING_CHAR, "[1, \"a\x01\"]", 6);
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX, "[\"ab\\u12G4\"]", 4);
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, "{\"a\":1 \"b\"}", 7);
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, "[1,2", 4);
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK, "[\"abc", 5);
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "[0, 1e309]", 4);
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_INVALID_VALUE, "[0, tru]", 4);
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_ROOT_NOT_SINGULAR, " null x", 6);
+	EXPECT_VALIDATE_ERROR(LEPT_PARSE_EXPECT_VALUE, "  ", 2);
+
+	/* 不分配内存；超过 LEPT_VALIDATE_STACK_DEPTH 层的嵌套才从分配器取位图 */
+	a.malloc_fn = counting_malloc;
+	a.realloc_fn = counting_realloc;
+	a.free_fn = counting_free;
+	a.ctx = &heap;
+	n = 100000;
+	deep = (char *)malloc(2 * n + 1);
+	memset(deep, '[', n);
+	memset(deep + n, ']', n);
+	lept_set_allocator(&a);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_validate(docs[17], strlen(docs[17]), 0, NULL));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_validate(deep + n - 1000, 2000, 0, NULL));
+	EXPECT_EQ_SIZE_T(0, heap.calls);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_validate(deep, 2 * n, 0, &offset));
+	EXPECT_EQ_SIZE_T(2 * n, offset);
+	EXPECT_TRUE(heap.calls > 0);
+	deep[2 * n - 1] = '}';
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_validate(deep, 2 * n, 0, &offset));
+	EXPECT_EQ_SIZE_T(2 * n - 1, offset);
+	lept_set_allocator(NULL);
+	EXPECT_EQ_SIZE_T(0, heap.live);
+	free(deep);
+}
+
+/* 不校验时原样接受；校验时解析与 lept_validate() 都在同一个位置报错 */
+static void utf8_check(const char *json, int expect_error, size_t expect_offset) {
+	lept_parse_options opt;
+	lept_value v;
+	size_t offset = 0;
+	int ret;
+	opt.flags = LEPT_PARSE_FLAG_VALIDATE_UTF8;
+	opt.arena = NULL;
+	opt.symtab = NULL;
+	opt.max_depth = 0;
+	opt.stats = NULL;
+	opt.allocator = NULL;
+	opt.offset = &offset;
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, (char *)json));
+	lept_free(&v);
+	ret = lept_parse_ex(&v, (char *)json, &opt);
+	EXPECT_EQ_INT(expect_error, ret);
+	EXPECT_EQ_SIZE_T(expect_offset, offset);
+	lept_free(&v);
+	ret = lept_validate(json, strlen(json), LEPT_PARSE_FLAG_VALIDATE_UTF8, &offset);
+	EXPECT_EQ_INT(expect_error, ret);
+	EXPECT_EQ_SIZE_T(expect_offset, offset);
+}
+
+static void test_parse_utf8() {
+	/* 1~4 字节各一个，共 10 字节 */
+	static const char unit[] = "a\xC3\xA9\xE2\x82\xAC\xF0\x9D\x84\x9E";
+	static const size_t lead[] = { 0, 1, 1, 3, 3, 3, 6, 6, 6, 6 };
+	char json[104];
+	lept_value v;
+	size_t i, j;
+	utf8_check("\"\"", LEPT_PARSE_OK, 2);
+	utf8_check("[\"\xC2\x80\xDF\xBF\xE0\xA0\x80\xED\x9F\xBF\xEE\x80\x80\xF0\x90\x80\x80\xF4\x8F\xBF\xBF\", \"\\u00E9\xC3\xA9\"]", LEPT_PARSE_OK, 37);
+	utf8_check("\"\x80\"", LEPT_PARSE_INVALID_UTF8, 1);          /* 单独的延续字节 */
+	utf8_check("\"\xC0\xAF\"", LEPT_PARSE_INVALID_UTF8, 1);      /* 过长编码 */
+	utf8_check("\"\xC1\xBF\"", LEPT_PARSE_INVALID_UTF8, 1);
+	utf8_check("\"\xE0\x9F\xBF\"", LEPT_PARSE_INVALID_UTF8, 1);
+	utf8_check("\"\xF0\x8F\xBF\xBF\"", LEPT_PARSE_INVALID_UTF8, 1);
+	utf8_check("\"\xED\xA0\x80\"", LEPT_PARSE_INVALID_UTF8, 1);  /* 代理项 */
+	utf8_check("\"\xF4\x90\x80\x80\"", LEPT_PARSE_INVALID_UTF8, 1); /* 超过 U+10FFFF */
+	utf8_check("\"\xF5\x80\x80\x80\"", LEPT_PARSE_INVALID_UTF8, 1);
+	utf8_check("\"\xFF\"", LEPT_PARSE_INVALID_UTF8, 1);
+	utf8_check("\"ab\xE2\x82\"", LEPT_PARSE_INVALID_UTF8, 3);     /* 被引号截断 */
+	utf8_check("\"\xC3\xA9\xA9\"", LEPT_PARSE_INVALID_UTF8, 3);
+	utf8_check("\"\\n\xE2\x82\\n\"", LEPT_PARSE_INVALID_UTF8, 3);
+	utf8_check("{\"\xC3\":1}", LEPT_PARSE_INVALID_UTF8, 2);       /* 键 */
+	utf8_check("[\"a\", [\"\xF0\x9D\x84\"]]", LEPT_PARSE_INVALID_UTF8, 8);
+
+	/* 足够长，经过向量内核的整块和尾部；每个位置换成非法字节，都应报在所在序列的开头 */
+	json[0] = '\"';
+	for (i = 0; i < 10; i++)
+		memcpy(json + 1 + i * 10, unit, 10);
+	json[101] = '\"';
+	json[102] = '\0';
+	utf8_check(json, LEPT_PARSE_OK, 102);
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	EXPECT_EQ_SIZE_T(100, lept_get_len(&v));
+	EXPECT_TRUE(memcmp(lept_get_string(&v), json + 1, 100) == 0);
+	lept_free(&v);
+	for (i = 0; i < 100; i++) {
+		char saved = json[1 + i], next = json[2 + i];
+		json[1 + i] = (char)0xFF;
+		utf8_check(json, LEPT_PARSE_INVALID_UTF8, 1 + i - i % 10 + lead[i % 10]);
+		/* 引号截断序列 */
+		json[1 + i] = '\"';
+		if (lead[i % 10] != i % 10) {
+			json[2 + i] = '\0';
+			utf8_check(json, LEPT_PARSE_INVALID_UTF8, 1 + i - i % 10 + lead[i % 10]);
+			json[2 + i] = next;
+		}
+		json[1 + i] = saved;
+	}
+	for (j = 0; j < 102; j++)
+		EXPECT_TRUE(json[j] == (j == 0 || j == 101 ? '\"' : unit[(j - 1) % 10]));
+
+	/* 惰性解析时暂不解码的字符串也要检查 */
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_UTF8, lept_parse_lazy(&v, "[[\"\xFF\"]]", 7, LEPT_PARSE_FLAG_VALIDATE_UTF8));
+	lept_free(&v);
+}
+
+/* 把 SAX 事件记录成一行文本；第 abort_at 个事件（从 1 开始，0 表示不中止）返回 0 */
+typedef struct {
+	char trace[256];
+	size_t len;
+	int events, abort_at;
+}sax_recorder;
+
+static int sax_record(void *ctx, const char *tag, const char *s, size_t len) {
+	sax_recorder *r = (sax_recorder *)ctx;
+	size_t n = strlen(tag);
+	memcpy(r->trace + r->len, tag, n);
+	memcpy(r->trace + r->len + n, s, len);
+	r->len += n + len;
+	r->trace[r->len++] = ' ';
+	r->trace[r->len] = '\0';
+	return ++r->events != r->abort_at;
+}
+
+static int sax_null(void *ctx) { return sax_record(ctx, "n", "", 0); }
+static int sax_boolean(void *ctx, int b) { return sax_record(ctx, b ? "t" : "f", "", 0); }
+static int sax_string(void *ctx, const char *s, size_t len) { return sax_record(ctx, "s:", s, len); }
+static int sax_key(void *ctx, const char *s, size_t len) { return sax_record(ctx, "k:", s, len); }
+static int sax_start_object(void *ctx) { return sax_record(ctx, "{", "", 0); }
+static int sax_start_array(void *ctx) { return sax_record(ctx, "[", "", 0); }
+
+static int sax_number(void *ctx, double n) {
+	char buf[32];
+	return sax_record(ctx, "", buf, sprintf(buf, "%g", n));
+}
+
+static int sax_end_object(void *ctx, size_t size) {
+	char buf[32];
+	return sax_record(ctx, "}", buf, sprintf(buf, "%u", (unsigned)size));
+}
+
+static int sax_end_array(void *ctx, size_t size) {
+	char buf[32];
+	return sax_record(ctx, "]", buf, sprintf(buf, "%u", (unsigned)size));
+}
+
+#define EXPECT_TEST_SAX(error, expect, json, abort_event) \
+	do { \
+		sax_recorder r; \
+		r.len = 0; \
+		r.trace[0] = '\0'; \
+		r.events = 0; \
+		r.abort_at = abort_event; \
+		EXPECT_EQ_INT(error, lept_parse_sax(json, &handler, &r)); \
+		EXPECT_EQ_STRING(expect, r.trace, r.len); \
+	} while(0)
+
+static void test_parse_sax() {
+	static const char *invalid[] = {
+		"", " ", "nul", "?", "+0", ".123", "1.", "INF", "1e309", "[1,]", "[\"a\", nul]", "[1", "[1}", "[1 2",
+		"\"", "\"abc", "\"\\v\"", "\"\x01\"", "\"\\u012\"", "\"\\uD800\"", "\"\\uD800\\uE000\"",
+		"{:1,", "{1:1,", "{\"a\":1,", "{\"a\"}", "{\"a\",\"b\"}", "{\"a\":1", "{\"a\":1]", "{\"a\":{}", "null x", "[[[[{\"a\":[1,\"x\\q\"]}]]]]"
+	};
+	lept_sax_handler handler = {
+		sax_null, sax_boolean, sax_number, sax_string, sax_key,
+		sax_start_object, sax_end_object, sax_start_array, sax_end_array
+	};
+	lept_sax_handler numbers_only = { NULL, NULL, sax_number, NULL, NULL, NULL, NULL, NULL, NULL };
+	size_t i;
+	EXPECT_TEST_SAX(LEPT_PARSE_OK, "n ", " null ", 0);
+	EXPECT_TEST_SAX(LEPT_PARSE_OK, "-1.5 ", "-1.5", 0);
+	EXPECT_TEST_SAX(LEPT_PARSE_OK, "s:a\nb ", "\"a\\nb\"", 0);
+	EXPECT_TEST_SAX(LEPT_PARSE_OK, "[ ]0 ", "[ ]", 0);
+	EXPECT_TEST_SAX(LEPT_PARSE_OK, "{ }0 ", "{ }", 0);
+	EXPECT_TEST_SAX(LEPT_PARSE_OK, "{ k:a [ t f n 1 s:x ]5 k:b { k:c { }0 }1 }2 ",
+		"{ \"a\" : [ true, false, null, 1, \"x\" ], \"b\" : { \"c\" : { } } }", 0);
+	/* 中止后不再有事件 */
+	EXPECT_TEST_SAX(LEPT_PARSE_SAX_ABORTED, "[ 1 2 ", "[1,2,3]", 3);
+	EXPECT_TEST_SAX(LEPT_PARSE_SAX_ABORTED, "{ k:a ", "{\"a\":1}", 2);
+	EXPECT_TEST_SAX(LEPT_PARSE_SAX_ABORTED, "[ ]0 ", "[]", 2);
+	EXPECT_TEST_SAX(LEPT_PARSE_ROOT_NOT_SINGULAR, "n ", "null x", 0);
+
+	for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+		sax_recorder r;
+		lept_value v;
+		r.len = 0;
+		r.events = r.abort_at = 0;
+		lept_init(&v);
+		EXPECT_EQ_INT(lept_parse(&v, (char *)invalid[i]), lept_parse_sax(invalid[i], &handler, &r));
+		lept_free(&v);
+	}
+
+	{
+		sax_recorder r;
+		r.len = 0;
+		r.events = r.abort_at = 0;
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_sax("{\"a\":[1,null,\"2\",{\"b\":3e2}]}", &numbers_only, &r));
+		EXPECT_EQ_STRING("1 300 ", r.trace, r.len);
+	}
+
+	/* 只读取 json[0, len)：后面的内容不影响结果，范围内的 '\0' 是非法字符 */
+	{
+		sax_recorder r;
+		r.len = 0;
+		r.events = r.abort_at = 0;
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_sax_n("[1,\"a\"]garbage", 7, &handler, &r));
+		EXPECT_EQ_STRING("[ 1 s:a ]2 ", r.trace, r.len);
+		r.len = 0;
+		EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_sax_n("[1,2]", 4, &handler, &r));
+		EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_CHAR, lept_parse_sax_n("\"a\0b\"", 5, &handler, &r));
+		EXPECT_EQ_INT(LEPT_PARSE_EXPECT_VALUE, lept_parse_sax_n(NULL, 0, &handler, &r));
+	}
+}
+
+/* 把每个文档按不同的块大小喂给同一个 lept_parser，结果和错误码都应与 lept_parse() 一致 */
+static void test_parse_feed() {
+	static const char *docs[] = {
+		"null", " true ", "false", "0", "-0.0", "123.456e-7", "1E+10", "-1.7976931348623157e308", "12345678901234567890123",
+		"\"\"", "\"Hello\\nWorld\"", "\"\\\" \\\\ \\/ \\b \\f \\n \\r \\t\"", "\"\\u0024\\u00A2\\u20AC\\uD834\\uDD1E\\ud834\\udd1e\"",
+		"[ ]", "[ null , false , true , 123 , \"abc\" ]", "[ [ ] , [ 0 ] , [ 0 , 1 ] , [ 0 , 1 , 2 ] ]",
+		" { \"n\" : null , \"f\" : false , \"t\" : true , \"i\" : 123 , \"s\" : \"abc\", \"a\" : [ 1, 2, 3 ],"
+		" \"o\" : { \"1\" : 1, \"2\" : 2, \"3\" : 3 } } ",
+		"{\"a\":0,\"b\":1,\"c\":2,\"d\":3,\"e\":4,\"f\":5,\"g\":6,\"h\":7,\"i\":8,\"j\":9,\"k\":10,\"l\":11,\"m\":12,\"n\":13,\"o\":14,\"p\":15,\"q\":16}",
+		"", " ", "nul", "?", "+0", ".123", "1.", "1e", "1e+", "-", "INF", "nan", "0123", "0x0", "1e309", "-1e309",
+		"null x", "[1,]", "[\"a\", nul]", "[1", "[1}", "[1 2", "[[]",
+		"\"", "\"abc", "\"\\v\"", "\"\\", "\"\\u", "\"\\u01", "\"\\u012\"", "\"\\uDBFF\"", "\"\\uD800\\", "\"\\uD800\\u", "\"\\uD800\\uDBFF\"", "\"\x01\"", "\"\x1F\"",
+		"{:1,", "{1:1,", "{true:1,", "{\"a\":1,", "{\"a\"}", "{\"a\",\"b\"}", "{\"a\"", "{\"a\":", "{\"a\":1", "{\"a\":1]", "{\"a\":1 \"b\"", "{\"a\":{}"
+	};
+	static const size_t chunks[] = { 1, 2, 3, 5, 7, 64 };
+	lept_parser *p = lept_parser_create();
+	size_t i, j, k, n, len;
+	for (i = 0; i < sizeof(docs) / sizeof(docs[0]); i++) {
+		lept_value expect, v;
+		char *json = NULL, *json2 = NULL;
+		int ret, feed_ret;
+		lept_init(&expect);
+		ret = lept_parse(&expect, (char *)docs[i]);
+		if (ret == LEPT_PARSE_OK)
+			lept_stringify(&expect, &json, &len);
+		n = strlen(docs[i]);
+		for (j = 0; j < sizeof(chunks) / sizeof(chunks[0]); j++) {
+			feed_ret = LEPT_PARSE_OK;
+			for (k = 0; k < n; k += chunks[j])
+				feed_ret = lept_parse_feed(p, docs[i] + k, n - k < chunks[j] ? n - k : chunks[j]);
+			EXPECT_EQ_INT(ret, lept_parse_finish(p, &v));
+			EXPECT_TRUE(feed_ret == LEPT_PARSE_OK || feed_ret == ret);
+			if (ret == LEPT_PARSE_OK) {
+				EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &json2, &len));
+				EXPECT_TRUE(strcmp(json, json2) == 0);
+				free(json2);
+			}
+			else
+				EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+			lept_free(&v);
+		}
+		free(json);
+		lept_free(&expect);
+	}
+	/* 中途放弃的文档由 lept_parser_destroy 释放 */
+	lept_parse_feed(p, "{\"a\":[1,{\"b\":\"xy", 16);
+	lept_parser_destroy(p);
+}
+
+/* 把 sink 收到的各段拼接起来，并记录最大的一段；fail_after 段之后返回失败 */
+typedef struct {
+	char *buf;
+	size_t len, max_chunk;
+	int chunks, fail_after;
+}test_sink;
+
+static int test_sink_write(void *ctx, const char *buf, size_t len) {
+	test_sink *t = (test_sink *)ctx;
+	if (t->chunks++ == t->fail_after)
+		return -1;
+	t->buf = (char *)realloc(t->buf, t->len + len);
+	memcpy(t->buf + t->len, buf, len);
+	t->len += len;
+	if (len > t->max_chunk)
+		t->max_chunk = len;
+	return 0;
+}
+
+static void test_stringify_sink() {
+	static const size_t sizes[] = { 0, 64, 100, 4096 };
+	char json[4096], *expect, *p;
+	size_t i, j, len;
+	lept_value v;
+	test_sink t;
+	FILE *fp;
+	/* 长字符串、需要转义的字符和长键都会跨越缓冲区边界 */
+	p = json;
+	p += sprintf(p, "{\"");
+	for (i = 0; i < 300; i++)
+		*p++ = (char)('a' + i % 26);
+	p += sprintf(p, "\":[null,true,false,-1.5e-300,\"");
+	for (i = 0; i < 500; i++) {
+		if (i % 7)
+			*p++ = (char)('A' + i % 26);
+		else
+			p += sprintf(p, "\\u00%02X", (unsigned)(i % 32));
+	}
+	p += sprintf(p, "\\\"\\n\\t\",{},[],{\"\":\"\"}],\"n\\\"\\n\":123456789}");
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &expect, &len));
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		t.buf = NULL;
+		t.len = t.max_chunk = 0;
+		t.chunks = 0;
+		t.fail_after = -1;
+		EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_to_sink(&v, test_sink_write, &t, sizes[i]));
+		EXPECT_EQ_SIZE_T(len, t.len);
+		EXPECT_TRUE(t.len == len && memcmp(expect, t.buf, len) == 0);
+		EXPECT_TRUE(t.max_chunk <= (sizes[i] < 64 ? 64 : sizes[i]));
+		free(t.buf);
+	}
+	/* sink 失败后不再写入 */
+	for (j = 0; j < 3; j++) {
+		t.buf = NULL;
+		t.len = t.max_chunk = 0;
+		t.chunks = 0;
+		t.fail_after = (int)j;
+		EXPECT_EQ_INT(LEPT_STRINGIFY_SINK_ERROR, lept_stringify_to_sink(&v, test_sink_write, &t, 64));
+		EXPECT_EQ_INT((int)j + 1, t.chunks);
+		free(t.buf);
+	}
+	if ((fp = tmpfile()) != NULL) {
+		char *back = (char *)malloc(len + 1);
+		EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_to_sink(&v, lept_file_sink, fp, 256));
+		rewind(fp);
+		EXPECT_EQ_SIZE_T(len, fread(back, 1, len + 1, fp));
+		EXPECT_TRUE(memcmp(expect, back, len) == 0);
+		free(back);
+		fclose(fp);
+	}
+	free(expect);
+	lept_free(&v);
+}
+
+/* 输入放在大小恰好为 len 的堆内存里，越界读取会被 ASan 等工具发现 */
+#define EXPECT_TEST_PARSE_N(error, json, len) \
+	do { \
+		lept_value v; \
+		char *buf = (char *)malloc((len) + 1); \
+		memcpy(buf, json, len); \
+		lept_init(&v); \
+		EXPECT_EQ_INT(error, lept_parse_n(&v, buf, len)); \
+		lept_free(&v); \
+		free(buf); \
+	} while(0)
+
+static void test_parse_n() {
+	static const char *docs[] = {
+		"null", "true", "-1.5e10", "\"abc\"", "\"\\uD834\\uDD1E\"", "[1,[2,{\"a\":\"b\"}]]", " { } ",
+		"\"abc", "\"\\u12", "\"\\uD834\\u", "[1", "{\"a\"", "nul", "1e", "-"
+	};
+	size_t i, n;
+	int expect;
+	lept_value v;
+	FILE *fp;
+	for (i = 0; i < sizeof(docs) / sizeof(docs[0]); i++) {
+		lept_init(&v);
+		n = strlen(docs[i]);
+		expect = lept_parse(&v, (char *)docs[i]);
+		lept_free(&v);
+		EXPECT_TEST_PARSE_N(expect, docs[i], n);
+	}
+	/* 范围之后的内容不参与解析，范围之内的 '\0' 是非法字符 */
+	EXPECT_TEST_PARSE_N(LEPT_PARSE_OK, "[1,2]xyz", 5);
+	EXPECT_TEST_PARSE_N(LEPT_PARSE_OK, "123456", 3);
+	EXPECT_TEST_PARSE_N(LEPT_PARSE_MISS_QUOTATION_MARK, "\"abc\"", 4);
+	EXPECT_TEST_PARSE_N(LEPT_PARSE_EXPECT_VALUE, "null", 0);
+	EXPECT_TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "null", 3);
+	EXPECT_TEST_PARSE_N(LEPT_PARSE_ROOT_NOT_SINGULAR, "null\0", 5);
+	EXPECT_TEST_PARSE_N(LEPT_PARSE_INVALID_STRING_CHAR, "\"a\0b\"", 5);
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_IO_ERROR, lept_parse_file(&v, "no/such/file.json"));
+	EXPECT_EQ_INT(LEPT_VOID, lept_get_type(&v));
+	if ((fp = fopen("test_parse_file.json", "wb")) != NULL) {
+		fputs(" {\"a\":[1,2,\"x\\ny\"],\"b\":null} \n", fp);
+		fclose(fp);
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_file(&v, "test_parse_file.json"));
+		EXPECT_EQ_SIZE_T(2, lept_get_object_size(&v));
+		EXPECT_EQ_STRING("x\ny", lept_get_string(lept_get_array_element(lept_get_object_value(&v, 0), 2)), lept_get_len(lept_get_array_element(lept_get_object_value(&v, 0), 2)));
+		lept_free(&v);
+		fp = fopen("test_parse_file.json", "wb");
+		fclose(fp);
+		EXPECT_EQ_INT(LEPT_PARSE_EXPECT_VALUE, lept_parse_file(&v, "test_parse_file.json"));
+		remove("test_parse_file.json");
+	}
+}
+
+/* 每条记录的结果与单独用 lept_parse_n() 解析那一行相同，且按输入顺序排列 */
+static void test_parse_ndjson() {
+	static const char *lines[] = {
+		"{\"a\":[1,2,{\"b\":null}]}", "  ", "\"x\\ty\"\r", "[1,", "-0.5e3", "", "nul", "{\"k\":\"v\"} x", "[]"
+	};
+	static const unsigned threads[] = { 1, 2, 4, 0 };
+	lept_ndjson_record *r;
+	lept_value v;
+	char *buf, *s1, *s2;
+	size_t i, j, k, len = 0, n, records, l1, l2;
+	for (i = 0; i < sizeof(lines) / sizeof(lines[0]); i++)
+		len += strlen(lines[i]) + 1;
+	n = len * 100;
+	buf = (char *)malloc(n);
+	for (k = 0, len = 0; k < 100; k++)
+		for (i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+			memcpy(buf + len, lines[i], strlen(lines[i]));
+			len += strlen(lines[i]);
+			buf[len++] = '\n';
+		}
+	/* 最后一行没有换行符 */
+	len--;
+	for (j = 0; j < sizeof(threads) / sizeof(threads[0]); j++) {
+		records = lept_parse_ndjson(buf, len, threads[j], &r);
+		EXPECT_EQ_SIZE_T(700, records);
+		for (i = 0; i < records; i++) {
+			lept_init(&v);
+			EXPECT_EQ_INT(lept_parse_n(&v, buf + r[i].offset, r[i].length), r[i].error);
+			EXPECT_EQ_INT(i % 7 == 2 || i % 7 == 4 || i % 7 == 5, r[i].error != LEPT_PARSE_OK);
+			EXPECT_EQ_INT(lept_get_type(&v), lept_get_type(&r[i].v));
+			if (r[i].error == LEPT_PARSE_OK) {
+				lept_stringify(&v, &s1, &l1);
+				lept_stringify(&r[i].v, &s2, &l2);
+				EXPECT_EQ_SIZE_T(l1, l2);
+				EXPECT_TRUE(memcmp(s1, s2, l1) == 0);
+				free(s1);
+				free(s2);
+			}
+			lept_free(&v);
+		}
+		lept_ndjson_free(r, records);
+	}
+	EXPECT_EQ_SIZE_T(0, lept_parse_ndjson("\n \r\n\n", 5, 0, &r));
+	lept_ndjson_free(r, 0);
+	free(buf);
+}
+
+#define EXPECT_TEST_PARSE_PARALLEL(json, len, threads) \
+	do { \
+		lept_value a, b; \
+		char *s1, *s2; \
+		size_t l1, l2; \
+		lept_init(&a); \
+		lept_init(&b); \
+		EXPECT_EQ_INT(lept_parse_n(&a, json, len), lept_parse_parallel(&b, json, len, threads)); \
+		EXPECT_EQ_INT(lept_get_type(&a), lept_get_type(&b)); \
+		if (lept_get_type(&a) != LEPT_VOID && lept_get_type(&a) != LEPT_NULL) { \
+			lept_stringify(&a, &s1, &l1); \
+			lept_stringify(&b, &s2, &l2); \
+			EXPECT_EQ_SIZE_T(l1, l2); \
+			EXPECT_TRUE(memcmp(s1, s2, l1) == 0); \
+			free(s1); \
+			free(s2); \
+		} \
+		lept_free(&a); \
+		lept_free(&b); \
+	} while(0)
+
+/* 结果和错误码都与 lept_parse_n() 一致；字符串中的括号、逗号和转义的引号不影响切分 */
+static void test_parse_parallel() {
+	static const char *docs[] = {
+		"[]", " [ ] ", "[1]", "{\"a\":[1,2]}", "null", "\"[1,2]\"", " [ \"a,]\" , {\"b\":\"\\\"]\"} , [\"\\\\\",[]] ] ",
+		"", "[", "[1,", "[1,]", "[,1]", "[1 2]", "[1]]", "[1] x", "[{]}", "[\"abc]", "[\"\\\"]", "[1}", "[{\"a\":1]]"
+	};
+	static const char *elems[] = { "1", "\"x]\\\"y\"", "{\"k\":[true,{\"z\":null}]}", "[]", "\"\\\\\"", " -2.5e3 " };
+	static const unsigned threads[] = { 1, 2, 4, 0 };
+	char *buf;
+	size_t i, j, len = 0, n = 3000;
+	for (i = 0; i < sizeof(docs) / sizeof(docs[0]); i++)
+		for (j = 0; j < sizeof(threads) / sizeof(threads[0]); j++)
+			EXPECT_TEST_PARSE_PARALLEL(docs[i], strlen(docs[i]), threads[j]);
+	/* 足够多的元素才会真正分给多个线程 */
+	buf = (char *)malloc(n * 32);
+	buf[len++] = '[';
+	for (i = 0; i < n; i++) {
+		memcpy(buf + len, elems[i % 6], strlen(elems[i % 6]));
+		len += strlen(elems[i % 6]);
+		buf[len++] = i + 1 < n ? ',' : ']';
+	}
+	for (j = 0; j < sizeof(threads) / sizeof(threads[0]); j++)
+		EXPECT_TEST_PARSE_PARALLEL(buf, len, threads[j]);
+	/* 最后一个元素出错时其余线程的结果都要释放 */
+	buf[len - 2] = ':';
+	EXPECT_TEST_PARSE_PARALLEL(buf, len, 4);
+	free(buf);
+}
+
+/* 64 位平台上的节点大小；LEPT_COMPACT 下其余测试全部照常通过 */
+static void test_value_layout() {
+	if (sizeof(void *) != 8)
+		return;
+#ifdef LEPT_COMPACT
+	EXPECT_EQ_SIZE_T(16, sizeof(lept_value));
+	EXPECT_EQ_SIZE_T(28, sizeof(lept_member));
+#else
+	EXPECT_EQ_SIZE_T(24, sizeof(lept_value));
+	EXPECT_EQ_SIZE_T(40, sizeof(lept_member));
+#endif
+}
+
+/* 内联与堆上存放的分界附近，各种解析方式得到的字符串和键都完整且以 '\0' 结尾 */
+static void test_inline_string() {
+	char s[41], json[160], *out;
+	size_t len, i, n;
+	lept_value v;
+	lept_arena arena;
+	lept_parser *p;
+	for (len = 0; len <= 40; len++) {
+		for (i = 0; i < len; i++)
+			s[i] = (char)('a' + i % 26);
+		s[len] = '\0';
+		lept_init(&v);
+		lept_set_string(&v, s, len);
+		EXPECT_EQ_SIZE_T(len, lept_get_len(&v));
+		EXPECT_TRUE(memcmp(s, lept_get_string(&v), len + 1) == 0);
+		/* 至少 11 字节以内的字符串不需要单独分配 */
+		if (len <= 11)
+			EXPECT_TRUE(lept_get_string(&v) >= (const char *)&v && lept_get_string(&v) < (const char *)(&v + 1));
+		lept_free(&v);
+
+		sprintf(json, "{\"%s\":\"%s\",\"k\":[\"%s\"]}", s, s, s);
+		for (i = 0; i < 4; i++) {
+			lept_init(&v);
+			if (i == 0)
+				EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+			else if (i == 1) {
+				lept_arena_init(&arena, 0);
+				EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&v, json, &arena));
+			}
+			else if (i == 2) {
+				p = lept_parser_create();
+				EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_feed(p, json, strlen(json)));
+				EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_finish(p, &v));
+				lept_parser_destroy(p);
+			}
+			else {
+				char copy[160];
+				strcpy(copy, json);
+				EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_insitu(&v, copy));
+				EXPECT_TRUE(memcmp(s, lept_get_object_key(&v, 0), len + 1) == 0);
+				lept_free(&v);
+				continue;
+			}
+			EXPECT_EQ_SIZE_T(len, lept_get_object_key_len(&v, 0));
+			EXPECT_TRUE(memcmp(s, lept_get_object_key(&v, 0), len + 1) == 0);
+			EXPECT_TRUE(memcmp(s, lept_get_string(lept_get_object_value(&v, 0)), len + 1) == 0);
+			EXPECT_EQ_SIZE_T(1, lept_find_object_index(&v, "k", 1));
+			lept_stringify(&v, &out, &n);
+			EXPECT_EQ_SIZE_T(strlen(json), n);
+			EXPECT_TRUE(memcmp(json, out, n) == 0);
+			free(out);
+			lept_free(&v);
+			if (i == 1)
+				lept_arena_free(&arena);
+		}
+	}
+}
+
 int main() {
 #ifdef _WINDOWS
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
 	test_parse();
 	printf("%d/%d (%3.2f%%) passed!\n", test_pass, test_count, test_pass * 100.0 / test_count);
+#ifdef _WINDOWS
 	getchar();
+#endif
 	return main_ret;
 }
\ No newline at end of file